@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Allocations.h"
+#include <atomic>
+
+namespace athena
+{
+  /** The installed allocation tracker.
+   */
+  static std::atomic<const Tracker*> installed( nullptr ) ;
+
+  void setTracker( const Tracker* tracker )
+  {
+    installed = tracker ;
+  }
+
+  bool allocationsTracked()
+  {
+    return installed.load() != nullptr ;
+  }
+
+  bool startAllocations()
+  {
+    const Tracker* tracker = installed ;
+    
+    if( tracker == nullptr ) return false ;
+    
+    tracker->start() ;
+    return true ;
+  }
+
+  void stopAllocations( Allocations& allocations )
+  {
+    const Tracker* tracker = installed ;
+    
+    allocations = Allocations() ;
+    if( tracker == nullptr ) return ;
+    
+    tracker->stop( allocations ) ;
+    allocations.tracked = true ;
+  }
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATHENA_ALLOCATIONS_H
+#define ATHENA_ALLOCATIONS_H
+
+#include <cstdint>
+
+namespace athena
+{
+  /** The budget of a test that may allocate without limit.
+   */
+  constexpr std::uint64_t BUDGET_UNLIMITED = ~static_cast<std::uint64_t>( 0 ) ;
+
+  /** Structure to contain the heap allocations made by a test.
+   */
+  struct Allocations
+  {
+    std::uint64_t count   ; ///< The amount of allocations.
+    std::uint64_t bytes   ; ///< The total amount of bytes requested.
+    std::uint64_t peak    ; ///< The most bytes the test had allocated at once, beyond what it started with.
+    bool          tracked ; ///< Whether or not allocations were tracked. Every count is zero otherwise.
+  };
+
+  /** Structure to contain the functions of an allocation tracker, which counts the allocations of the calling thread.
+   * The athena_allocations library installs one when it is linked into a program.
+   */
+  struct Tracker
+  {
+    void ( *start )(                          ) ; ///< Starts counting from zero.
+    void ( *stop  )( Allocations& allocations ) ; ///< Stops counting and fills out what was counted.
+  };
+
+  /** Function to install the allocation tracker tests are tracked with.
+   * @param tracker The tracker to install, which must live as long as the program. Null uninstalls it.
+   */
+  void setTracker( const Tracker* tracker ) ;
+
+  /** Function to check whether an allocation tracker is installed.
+   * @return Whether or not allocations can be tracked.
+   */
+  bool allocationsTracked() ;
+
+  /** Function to start tracking the allocations of the calling thread.
+   * @return Whether or not allocations are tracked.
+   */
+  bool startAllocations() ;
+
+  /** Function to stop tracking the allocations of the calling thread, started with startAllocations.
+   * @param allocations Reference to the allocations to fill out.
+   */
+  void stopAllocations( Allocations& allocations ) ;
+}
+
+#endif
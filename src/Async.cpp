@@ -0,0 +1,440 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Async.h"
+#include "Record.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+namespace athena
+{
+  /** Alias for a chrono time point since that name is super long.
+   */
+  typedef std::chrono::steady_clock::time_point TimePoint ;
+
+  /** The most descriptor events an event loop handles per wait.
+   */
+  constexpr int LOOP_EVENTS = 64 ;
+
+  /** Structure to contain a single coroutine test of an event loop.
+   */
+  struct Slot
+  {
+    Coroutine coroutine  ; ///< The coroutine of the test.
+    unsigned  task       ; ///< The index of the test's task.
+    TimePoint begin      ; ///< When the test started.
+    int       descriptor ; ///< The file descriptor the test waits on, or -1.
+    unsigned  generation ; ///< Bumped every time the test is resumed, so a timer from an earlier wait is ignored.
+    bool      live       ; ///< Whether the test is still running.
+  };
+
+  /** Structure to contain a single timer of an event loop, waking a test up or timing it out.
+   */
+  struct Timer
+  {
+    TimePoint when       ; ///< When the timer fires.
+    unsigned  slot       ; ///< The test the timer belongs to.
+    unsigned  generation ; ///< The generation of the test when the timer was set.
+    bool      expire     ; ///< Whether the timer times the test out, rather than waking it up.
+
+    /** Comparison operator, ordering timers so the earliest is at the top of a heap.
+     * @param timer The timer to compare against.
+     * @return Whether this timer fires after the input.
+     */
+    bool operator>( const Timer& timer ) const { return this->when > timer.when ; }
+  };
+
+  /** Structure to contain the event loop of a single executor thread.
+   */
+  struct EventLoop
+  {
+    typedef std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> TimerQueue ;
+
+    std::vector<unsigned> tasks   ;
+    std::vector<Slot>     slots   ;
+    TimerQueue            timers  ;
+    std::deque<unsigned>  ready   ;
+    unsigned              current ;
+    unsigned              live    ;
+    int                   poller  ;
+
+    /** Default constructor.
+     */
+    EventLoop() ;
+
+    /** Method to run every task of this loop to completion.
+     * @param start The function starting each task.
+     * @param resume The function resuming each task.
+     * @param finish The function called as each task finishes.
+     * @param limit The function returning how long each task may run.
+     * @param end The time at which every unfinished task times out.
+     */
+    void run( const Executor::Start& start, const Executor::Resume& resume, const Executor::Finish& finish, const Executor::Limit& limit, TimePoint end ) ;
+
+    /** Method to resume every test that is ready, finishing the ones that are done.
+     * @param resume The function resuming each task.
+     * @param finish The function called as each task finishes.
+     */
+    void step( const Executor::Resume& resume, const Executor::Finish& finish ) ;
+
+    /** Method to wait for the next timer or descriptor, and queue every test it wakes up.
+     * @param finish The function called as each task times out.
+     * @param end The time at which the run's deadline passes.
+     */
+    void wait( const Executor::Finish& finish, TimePoint end ) ;
+
+    /** Method to stop waiting on a test's descriptor, if it waits on one.
+     * @param slot The test to stop waiting for.
+     */
+    void forget( Slot& slot ) ;
+  };
+
+  struct ExecutorData
+  {
+    std::unique_ptr<EventLoop[]> loops   ;
+    unsigned                     threads ;
+    unsigned                     next    ;
+
+    /** Default constructor.
+     */
+    ExecutorData() ;
+  };
+
+  /** The event loop running on each thread, if any.
+   */
+  static thread_local EventLoop* current_loop = nullptr ;
+
+  EventLoop::EventLoop()
+  {
+    this->current = 0  ;
+    this->live    = 0  ;
+    this->poller  = -1 ;
+  }
+
+  void EventLoop::run( const Executor::Start& start, const Executor::Resume& resume, const Executor::Finish& finish, const Executor::Limit& limit, TimePoint end )
+  {
+    Slot   slot    ;
+    double allowed ;
+
+#ifdef __linux__
+    this->poller = epoll_create1( EPOLL_CLOEXEC ) ;
+#endif
+
+    current_loop = this ;
+    this->slots.reserve( this->tasks.size() ) ;
+
+    // Every test runs up to its first suspension as it starts, before the loop waits on anything.
+    for( unsigned task : this->tasks )
+    {
+      slot            = Slot() ;
+      slot.task       = task   ;
+      slot.descriptor = -1     ;
+      if( !start( task, slot.coroutine ) ) continue ;
+
+      slot.begin = std::chrono::steady_clock::now() ;
+      slot.live  = true                            ;
+      allowed    = limit( task )                   ;
+
+      this->slots.push_back( slot ) ;
+      this->ready.push_back( this->slots.size() - 1 ) ;
+      this->live++ ;
+
+      if( allowed > 0.0 )
+      {
+        this->timers.push( { slot.begin + std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double, std::milli>( allowed ) ),
+                             static_cast<unsigned>( this->slots.size() - 1 ), 0, true } ) ;
+      }
+
+      this->step( resume, finish ) ;
+    }
+
+    while( this->live > 0 )
+    {
+      this->wait( finish, end ) ;
+      this->step( resume, finish ) ;
+    }
+
+#ifdef __linux__
+    if( this->poller >= 0 ) close( this->poller ) ;
+#endif
+
+    current_loop = nullptr ;
+    this->poller = -1      ;
+    this->tasks.clear() ;
+    this->slots.clear() ;
+    this->ready.clear() ;
+    this->timers = TimerQueue() ;
+  }
+
+  void EventLoop::step( const Executor::Resume& resume, const Executor::Finish& finish )
+  {
+    Record   record ;
+    unsigned index  ;
+
+    while( !this->ready.empty() )
+    {
+      index = this->ready.front() ;
+      this->ready.pop_front() ;
+
+      Slot& slot = this->slots[ index ] ;
+      if( !slot.live ) continue ;
+
+      slot.generation++ ;
+      this->current = index ;
+      resume( slot.task, slot.coroutine ) ;
+
+      if( !slot.coroutine.done( slot.coroutine.frame ) ) continue ;
+
+      record        = Record() ;
+      record.time   = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - slot.begin ).count() ;
+      record.result = Result( slot.coroutine.result( slot.coroutine.frame ) ) ;
+      slot.live     = false ;
+
+      slot.coroutine.destroy( slot.coroutine.frame ) ;
+      this->live-- ;
+      finish( slot.task, record ) ;
+    }
+  }
+
+  void EventLoop::wait( const Executor::Finish& finish, TimePoint end )
+  {
+    Record    record  ;
+    TimePoint now     ;
+    TimePoint next    ;
+    Timer     timer   ;
+    int       timeout ;
+
+    // Timers of tests that were resumed or finished since they were set are dropped as they come up.
+    while( !this->timers.empty() )
+    {
+      timer = this->timers.top() ;
+      if( this->slots[ timer.slot ].live && ( timer.expire || timer.generation == this->slots[ timer.slot ].generation ) ) break ;
+      this->timers.pop() ;
+    }
+
+    now  = std::chrono::steady_clock::now() ;
+    next = std::min( end, this->timers.empty() ? TimePoint::max() : this->timers.top().when ) ;
+
+    timeout = -1 ;
+    if( next != TimePoint::max() )
+    {
+      timeout = next <= now ? 0 : static_cast<int>( std::ceil( std::chrono::duration<double, std::milli>( next - now ).count() ) ) ;
+    }
+
+#ifdef __linux__
+    epoll_event events[ LOOP_EVENTS ] ;
+    int         count                 ;
+
+    count = 0 ;
+    if     ( this->poller >= 0 ) count = epoll_wait( this->poller, events, LOOP_EVENTS, timeout ) ;
+    else if( timeout > 0       ) std::this_thread::sleep_for( std::chrono::milliseconds( timeout ) ) ;
+    
+    for( int index = 0; index < count; index++ )
+    {
+      Slot& slot = this->slots[ events[ index ].data.u32 ] ;
+
+      this->forget( slot ) ;
+      this->ready.push_back( events[ index ].data.u32 ) ;
+    }
+#else
+    if( timeout > 0 ) std::this_thread::sleep_for( std::chrono::milliseconds( timeout ) ) ;
+#endif
+
+    now = std::chrono::steady_clock::now() ;
+
+    // Once the deadline passes, every test still running times out with it.
+    if( now >= end )
+    {
+      for( auto& slot : this->slots )
+      {
+        if( !slot.live ) continue ;
+
+        record        = Record() ;
+        record.time   = std::chrono::duration<double, std::micro>( now - slot.begin ).count() ;
+        record.reason = Reason::Deadline ;
+        record.result.set( Result::Timeout ) ;
+
+        this->forget( slot ) ;
+        slot.live = false ;
+        slot.coroutine.destroy( slot.coroutine.frame ) ;
+        this->live-- ;
+        finish( slot.task, record ) ;
+      }
+
+      return ;
+    }
+
+    while( !this->timers.empty() && this->timers.top().when <= now )
+    {
+      timer = this->timers.top() ;
+      this->timers.pop() ;
+
+      Slot& slot = this->slots[ timer.slot ] ;
+      if( !slot.live ) continue ;
+
+      if( !timer.expire )
+      {
+        if( timer.generation == slot.generation ) this->ready.push_back( timer.slot ) ;
+        continue ;
+      }
+
+      // A timed out test is destroyed where it is suspended, which also destroys whatever it was awaiting.
+      record      = Record() ;
+      record.time = std::chrono::duration<double, std::micro>( now - slot.begin ).count() ;
+      record.result.set( Result::Timeout ) ;
+
+      this->forget( slot ) ;
+      slot.live = false ;
+      slot.coroutine.destroy( slot.coroutine.frame ) ;
+      this->live-- ;
+      finish( slot.task, record ) ;
+    }
+  }
+
+  void EventLoop::forget( Slot& slot )
+  {
+#ifdef __linux__
+    if( slot.descriptor >= 0 ) epoll_ctl( this->poller, EPOLL_CTL_DEL, slot.descriptor, nullptr ) ;
+#endif
+    slot.descriptor = -1 ;
+  }
+
+  ExecutorData::ExecutorData()
+  {
+    this->threads = 0 ;
+    this->next    = 0 ;
+  }
+
+  bool suspendFor( double milliseconds )
+  {
+    const auto duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double, std::milli>( milliseconds ) ) ;
+
+    if( current_loop == nullptr )
+    {
+      std::this_thread::sleep_for( duration ) ;
+      return false ;
+    }
+
+    const unsigned slot = current_loop->current ;
+
+    current_loop->timers.push( { std::chrono::steady_clock::now() + duration, slot, current_loop->slots[ slot ].generation, false } ) ;
+    return true ;
+  }
+
+  bool suspendOn( int descriptor, bool write )
+  {
+#ifdef __linux__
+    epoll_event event ;
+
+    if( current_loop == nullptr || current_loop->poller < 0 ) return false ;
+
+    event          = epoll_event()                 ;
+    event.events   = write ? EPOLLOUT : EPOLLIN    ;
+    event.data.u32 = current_loop->current         ;
+
+    // Descriptors that can't be polled, such as regular files, are always ready.
+    if( epoll_ctl( current_loop->poller, EPOLL_CTL_ADD, descriptor, &event ) != 0 ) return false ;
+
+    current_loop->slots[ current_loop->current ].descriptor = descriptor ;
+    return true ;
+#else
+    static_cast<void>( descriptor ) ;
+    static_cast<void>( write      ) ;
+    return false ;
+#endif
+  }
+
+  Executor::Executor()
+  {
+    this->executor_data = new ExecutorData() ;
+  }
+
+  Executor::~Executor()
+  {
+    delete this->executor_data ;
+  }
+
+  void Executor::initialize( unsigned threads )
+  {
+    if( threads == 0 ) threads = std::thread::hardware_concurrency() ;
+    if( threads == 0 ) threads = 1                                   ;
+
+    data().loops.reset( new EventLoop[ threads ] ) ;
+    data().threads = threads ;
+    data().next    = 0       ;
+  }
+
+  unsigned Executor::size() const
+  {
+    return data().threads ;
+  }
+
+  void Executor::push( unsigned task )
+  {
+    data().loops[ data().next ].tasks.push_back( task ) ;
+    data().next = ( data().next + 1 ) % data().threads ;
+  }
+
+  void Executor::run( const Start& start, const Resume& resume, const Finish& finish, const Limit& limit, double deadline )
+  {
+    std::vector<std::thread> threads ;
+    TimePoint                end     ;
+
+    end = TimePoint::max() ;
+    if( deadline > 0.0 )
+    {
+      end = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double, std::milli>( deadline ) ) ;
+    }
+
+    for( unsigned thread = 1; thread < data().threads; thread++ )
+    {
+      if( data().loops[ thread ].tasks.empty() ) continue ;
+      threads.emplace_back( [&, thread]() { data().loops[ thread ].run( start, resume, finish, limit, end ) ; } ) ;
+    }
+
+    data().loops[ 0 ].run( start, resume, finish, limit, end ) ;
+
+    for( auto& thread : threads )
+    {
+      thread.join() ;
+    }
+
+    data().next = 0 ;
+  }
+
+  ExecutorData& Executor::data()
+  {
+    return *this->executor_data ;
+  }
+
+  const ExecutorData& Executor::data() const
+  {
+    return *this->executor_data ;
+  }
+}
@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATHENA_ASYNC_H
+#define ATHENA_ASYNC_H
+
+#include "Registry.h"
+#include <functional>
+
+#if defined( __cpp_impl_coroutine ) && defined( __has_include )
+#if __has_include( <coroutine> )
+#define ATHENA_COROUTINES
+#include <coroutine>
+#endif
+#endif
+
+namespace athena
+{
+  struct Record ;
+
+  /** Function to suspend the running coroutine test until a time passes. Blocks the calling thread outside of an executor.
+   * @param milliseconds The time to wait for.
+   * @return Whether or not the coroutine was suspended, and is resumed by its executor once the time passed.
+   */
+  bool suspendFor( double milliseconds ) ;
+
+  /** Function to suspend the running coroutine test until a file descriptor is ready.
+   * Only one coroutine of an executor may wait on a descriptor at a time, and only where the platform has epoll.
+   * @param descriptor The file descriptor to wait on.
+   * @param write Whether to wait for the descriptor to be writable, rather than readable.
+   * @return Whether or not the coroutine was suspended, and is resumed by its executor once the descriptor is ready.
+   */
+  bool suspendOn( int descriptor, bool write ) ;
+
+  /** Class to run coroutine tests on a few threads, each multiplexing its share of the tests over one event loop.
+   * A coroutine stays on the thread it started on. Timers and file descriptor readiness wake it up, and a test's time is the
+   * wall time from its start to its end, however many other tests ran in between.
+   */
+  class Executor
+  {
+    public:
+
+      /** The function starting a task on its thread. Fills out the task's coroutine, or returns false to leave it unstarted.
+       */
+      typedef std::function<bool( unsigned task, Coroutine& coroutine )> Start ;
+
+      /** The function resuming a task's coroutine. Lets the caller set up the thread around every step of the coroutine.
+       */
+      typedef std::function<void( unsigned task, const Coroutine& coroutine )> Resume ;
+
+      /** The function called with the record of every finished or timed out task, on the task's thread.
+       */
+      typedef std::function<void( unsigned task, const Record& record )> Finish ;
+
+      /** The function deciding how long a task may run before it times out, in milliseconds. Zero lets it run forever.
+       */
+      typedef std::function<double( unsigned task )> Limit ;
+
+      /** Default constructor.
+       */
+      Executor() ;
+
+      /** Default deconstructor.
+       */
+      ~Executor() ;
+
+      /** Method to initialize this executor with a number of threads.
+       * @param threads The amount of threads to use. Zero uses every hardware thread.
+       */
+      void initialize( unsigned threads ) ;
+
+      /** Method to retrieve the number of threads of this executor.
+       * @return The number of threads of this executor.
+       */
+      unsigned size() const ;
+
+      /** Method to queue a task for the next run of this executor. Tasks are spread evenly over the threads.
+       * @param task The index of the task to queue.
+       */
+      void push( unsigned task ) ;
+
+      /** Method to run every queued task to completion. The calling thread runs the first event loop.
+       * A task running past its limit or the deadline is destroyed wherever it is suspended, and finished as timed out.
+       * @param start The function starting each task.
+       * @param resume The function resuming each task.
+       * @param finish The function called as each task finishes.
+       * @param limit The function returning how long each task may run.
+       * @param deadline The time in milliseconds after which every unfinished task times out. Zero never stops them.
+       */
+      void run( const Start& start, const Resume& resume, const Finish& finish, const Limit& limit, double deadline ) ;
+    private:
+
+      /** Forward-declared structure to contain this object's internal data.
+       */
+      struct ExecutorData *executor_data ;
+
+      /** Method to retrieve a reference to this object's internal data.
+       * @return Reference to this object's internal data.
+       */
+      ExecutorData& data() ;
+
+      /** Method to retrieve a const reference to this object's internal data.
+       * @return Const-reference to this object's internal data.
+       */
+      const ExecutorData& data() const ;
+  };
+
+#ifdef ATHENA_COROUTINES
+  /** Class returned by coroutine tests. Its coroutine finishes with a result, or anything convertible to one:
+   * @code
+   * manager.add( "echo", []() -> athena::Task { co_await athena::readable( socket ) ; co_return receive( socket ) == "ping" ; } ) ;
+   * @endcode
+   */
+  class Task
+  {
+    public:
+
+      /** Structure the compiler builds every coroutine of this type around.
+       */
+      struct promise_type
+      {
+        unsigned result = CALLABLE_PASS ; ///< The value of the result the coroutine finished with.
+
+        Task get_return_object() { return Task( std::coroutine_handle<promise_type>::from_promise( *this ) ) ; }
+
+        std::suspend_always initial_suspend() noexcept { return {} ; }
+
+        std::suspend_always final_suspend() noexcept { return {} ; }
+
+        void return_value( unsigned result ) { this->result = result ; }
+
+        void unhandled_exception() { throw ; }
+      };
+
+      /** Move constructor.
+       * @param task The task to take the coroutine of.
+       */
+      Task( Task&& task ) noexcept : handle( task.handle ) { task.handle = nullptr ; }
+
+      /** Deconstructor. Destroys the coroutine, unless it was started on an executor.
+       */
+      ~Task() { if( this->handle ) this->handle.destroy() ; }
+
+      Task( const Task& ) = delete ;
+
+      Task& operator=( const Task& ) = delete ;
+
+      /** Method to hand the coroutine over to an executor.
+       * @return The coroutine, which this object no longer owns.
+       */
+      Coroutine release()
+      {
+        Coroutine coroutine ;
+
+        coroutine.frame   = this->handle.address() ;
+        coroutine.resume  = []( void* frame ) { std::coroutine_handle<promise_type>::from_address( frame ).resume()  ; } ;
+        coroutine.destroy = []( void* frame ) { std::coroutine_handle<promise_type>::from_address( frame ).destroy() ; } ;
+        coroutine.done    = []( void* frame ) { return std::coroutine_handle<promise_type>::from_address( frame ).done() ; } ;
+        coroutine.result  = []( void* frame ) { return std::coroutine_handle<promise_type>::from_address( frame ).promise().result ; } ;
+        this->handle      = nullptr ;
+
+        return coroutine ;
+      }
+    private:
+
+      /** Constructor.
+       * @param handle The coroutine of this task.
+       */
+      explicit Task( std::coroutine_handle<promise_type> handle ) : handle( handle ) {}
+
+      std::coroutine_handle<promise_type> handle ;
+  };
+
+  template<>
+  struct Asynchronous<Task> : std::true_type
+  {
+    static Coroutine start( Task&& task ) { return task.release() ; }
+  };
+
+  /** Class awaited to suspend a coroutine test for a while, without holding up its thread.
+   */
+  class Delay
+  {
+    public:
+
+      /** Constructor.
+       * @param milliseconds The time to wait for.
+       */
+      explicit Delay( double milliseconds ) : milliseconds( milliseconds ) {}
+
+      bool await_ready() const noexcept { return this->milliseconds <= 0.0 ; }
+
+      bool await_suspend( std::coroutine_handle<> ) { return suspendFor( this->milliseconds ) ; }
+
+      void await_resume() const noexcept {}
+    private:
+      double milliseconds ;
+  };
+
+  /** Class awaited to suspend a coroutine test until a file descriptor is ready, without holding up its thread.
+   * Awaiting it yields whether the coroutine actually waited. It doesn't when the descriptor can't be waited on, as for
+   * regular files, which are always ready.
+   */
+  class Ready
+  {
+    public:
+
+      /** Constructor.
+       * @param descriptor The file descriptor to wait on.
+       * @param write Whether to wait for the descriptor to be writable, rather than readable.
+       */
+      Ready( int descriptor, bool write ) : descriptor( descriptor ), write( write ), waited( false ) {}
+
+      bool await_ready() const noexcept { return false ; }
+
+      bool await_suspend( std::coroutine_handle<> ) { return this->waited = suspendOn( this->descriptor, this->write ) ; }
+
+      bool await_resume() const noexcept { return this->waited ; }
+    private:
+      int  descriptor ;
+      bool write      ;
+      bool waited     ;
+  };
+
+  /** Function to wait for a while in a coroutine test.
+   * @param milliseconds The time to wait for.
+   * @return The awaitable.
+   */
+  inline Delay delay( double milliseconds ) { return Delay( milliseconds ) ; }
+
+  /** Function to wait for a file descriptor to be readable in a coroutine test.
+   * @param descriptor The file descriptor to wait on.
+   * @return The awaitable.
+   */
+  inline Ready readable( int descriptor ) { return Ready( descriptor, false ) ; }
+
+  /** Function to wait for a file descriptor to be writable in a coroutine test.
+   * @param descriptor The file descriptor to wait on.
+   * @return The awaitable.
+   */
+  inline Ready writable( int descriptor ) { return Ready( descriptor, true ) ; }
+#endif
+}
+
+#endif
@@ -0,0 +1,672 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include "Manager.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#if defined( __x86_64__ ) && defined( __linux__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define ATHENA_TSC
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+
+namespace athena
+{
+  /** The time a single sample should take to be timed reliably, in nanoseconds.
+   */
+  constexpr double SAMPLE_TIME = 1e6 ;
+
+  /** The minimum time to spend warming up before sampling, in nanoseconds.
+   */
+  constexpr double WARMUP_TIME = 1e7 ;
+
+  /** The time after which sampling stops even if the mean isn't stable yet, in nanoseconds.
+   */
+  constexpr double MAX_TIME = 5e8 ;
+
+  /** The relative standard error of the mean under which samples are considered stable.
+   */
+  constexpr double STABLE_ERROR = 0.01 ;
+
+  /** The minimum & maximum amount of samples to take.
+   */
+  constexpr unsigned MIN_SAMPLES = 10  ;
+  constexpr unsigned MAX_SAMPLES = 100 ;
+
+  /** The time spent calibrating the time stamp counter against the monotonic clock, in nanoseconds.
+   */
+  constexpr double CALIBRATION_TIME = 1e7 ;
+
+  /** The amount of times the empty loop is timed to find the overhead of a contended benchmark, keeping the median.
+   */
+  constexpr unsigned OVERHEAD_RUNS = 16 ;
+
+  /** The minimum amount of rounds taken when comparing variants, so the confidence interval has enough samples behind it.
+   */
+  constexpr unsigned MIN_ROUNDS = 20 ;
+
+  /** The amount of resamples of a bootstrapped confidence interval.
+   */
+  constexpr unsigned BOOTSTRAP_RESAMPLES = 2000 ;
+
+  /** The seed of the bootstrap's resampling, fixed so the same samples always give the same interval.
+   */
+  constexpr std::uint64_t BOOTSTRAP_SEED = 0x9e3779b97f4a7c15ull ;
+
+  /** The time a batch of iterations timed on one of several threads should take on a single thread, in nanoseconds. Short
+   * enough that every thread takes many samples, so their tail shows up.
+   */
+  constexpr double BATCH_TIME = 1e4 ;
+
+  /** The time every amount of threads is measured for, in nanoseconds.
+   */
+  constexpr double CONTENTION_TIME = 5e7 ;
+
+  /** The size of a cache line, which threads writing to memory next to each other would share.
+   */
+  constexpr std::size_t CACHE_LINE = 64 ;
+
+  /** How much smaller the error of a faster growing complexity class must be to win over a slower growing one. Neighbouring
+   * classes differ little over a sweep, so without a margin noise alone would often pick the faster growing class.
+   */
+  constexpr double FIT_MARGIN = 0.75 ;
+
+  /** Structure to contain what one thread of a contended benchmark records, on cache lines of its own so the threads don't
+   * contend over their bookkeeping on top of the benchmark.
+   */
+  struct alignas( CACHE_LINE ) Lane
+  {
+    std::vector<double> samples ; ///< The time of an iteration in every batch the thread timed, in nanoseconds.
+    double              busy    ; ///< The total time of those batches, in nanoseconds.
+  };
+
+  /** Structure to contain the clock benchmarks are timed with.
+   */
+  struct Clock
+  {
+    bool   tsc   ; ///< Whether the time stamp counter is used rather than the steady clock.
+    double scale ; ///< The nanoseconds per tick of the time stamp counter.
+  };
+
+#ifdef ATHENA_TSC
+  /** Function to read the time stamp counter at the start of a measurement.
+   * The fences keep earlier instructions from finishing after the read, and later ones from starting before it.
+   * @return The current tick.
+   */
+  static inline std::uint64_t startTicks()
+  {
+    std::uint64_t ticks ;
+
+    _mm_lfence() ;
+    ticks = __rdtsc() ;
+    _mm_lfence() ;
+
+    return ticks ;
+  }
+
+  /** Function to read the time stamp counter at the end of a measurement.
+   * rdtscp waits for every earlier instruction to finish, and the fence keeps later ones from starting before the read.
+   * @return The current tick.
+   */
+  static inline std::uint64_t stopTicks()
+  {
+    std::uint64_t ticks     ;
+    unsigned      processor ;
+
+    ticks = __rdtscp( &processor ) ;
+    _mm_lfence() ;
+
+    return ticks ;
+  }
+
+  /** Function to check whether the time stamp counter can time benchmarks: it ticks at a constant rate whatever the core's
+   * frequency or sleep state, and rdtscp is there to read it. Some hypervisors hide rdtscp, which then raises SIGILL.
+   * @return Whether or not the counter is invariant and rdtscp is supported.
+   */
+  static bool usableTicks()
+  {
+    unsigned eax ;
+    unsigned ebx ;
+    unsigned ecx ;
+    unsigned edx ;
+
+    if( __get_cpuid( 0x80000000, &eax, &ebx, &ecx, &edx ) == 0 || eax < 0x80000007 ) return false ;
+    if( __get_cpuid( 0x80000001, &eax, &ebx, &ecx, &edx ) == 0                     ) return false ;
+    if( ( edx & ( 1u << 27 ) ) == 0                                                ) return false ;
+    if( __get_cpuid( 0x80000007, &eax, &ebx, &ecx, &edx ) == 0                     ) return false ;
+
+    return ( edx & ( 1u << 8 ) ) != 0 ;
+  }
+#endif
+
+  static const Clock& timer() ;
+
+  /** Function to time a single run of a loop.
+   * @param loop The loop to time.
+   * @param iterations The amount of iterations to run.
+   * @return The time the loop took, in nanoseconds.
+   */
+  static double timeLoop( const Loop& loop, std::uint64_t iterations )
+  {
+    std::chrono::steady_clock::time_point begin ;
+    std::chrono::steady_clock::time_point end   ;
+
+#ifdef ATHENA_TSC
+    if( timer().tsc )
+    {
+      const std::uint64_t first = startTicks() ;
+      loop( iterations ) ;
+      const std::uint64_t last  = stopTicks() ;
+
+      return ( last - first ) * timer().scale ;
+    }
+#endif
+
+    begin = std::chrono::steady_clock::now() ;
+    loop( iterations ) ;
+    end   = std::chrono::steady_clock::now() ;
+
+    return std::chrono::duration<double, std::nano>( end - begin ).count() ;
+  }
+
+  /** Function to set up the clock, calibrating the time stamp counter where it is used.
+   * @return The clock.
+   */
+  static Clock calibrate()
+  {
+    Clock clock ;
+
+    clock.tsc   = false ;
+    clock.scale = 1.0   ;
+
+#ifdef ATHENA_TSC
+    std::chrono::steady_clock::time_point begin   ;
+    std::chrono::steady_clock::time_point end     ;
+    std::uint64_t                         first   ;
+    std::uint64_t                         last    ;
+    double                                elapsed ;
+
+    if( usableTicks() && ( getenv( "ATHENA_TIMER" ) == nullptr || strcmp( getenv( "ATHENA_TIMER" ), "chrono" ) != 0 ) )
+    {
+      // Both clocks are read back to back at either end of a busy wait, so the error is a few ticks over millions.
+      begin = std::chrono::steady_clock::now() ;
+      first = startTicks()                     ;
+      do
+      {
+        end     = std::chrono::steady_clock::now() ;
+        elapsed = std::chrono::duration<double, std::nano>( end - begin ).count() ;
+      }
+      while( elapsed < CALIBRATION_TIME ) ;
+      last = stopTicks() ;
+
+      if( last > first )
+      {
+        clock.tsc   = true                       ;
+        clock.scale = elapsed / ( last - first ) ;
+      }
+    }
+#endif
+
+    return clock ;
+  }
+
+  /** Function to retrieve the clock, setting it up on first use.
+   * @return The clock.
+   */
+  static const Clock& timer()
+  {
+    static const Clock clock = calibrate() ;
+
+    return clock ;
+  }
+
+  /** Function to retrieve a percentile of sorted samples, interpolating between the closest two.
+   * @param sorted The sorted samples.
+   * @param count The amount of samples.
+   * @param percent The percentile to retrieve, from 0 to 1.
+   * @return The value at the percentile.
+   */
+  static double percentile( const double* sorted, unsigned count, double percent )
+  {
+    double   position ;
+    unsigned lower    ;
+
+    position = percent * ( count - 1 ) ;
+    lower    = static_cast<unsigned>( position ) ;
+
+    if( lower + 1 >= count ) return sorted[ count - 1 ] ;
+
+    return sorted[ lower ] + ( sorted[ lower + 1 ] - sorted[ lower ] ) * ( position - lower ) ;
+  }
+
+  /** Function to compute the relative standard error of the mean of a set of samples.
+   * @param samples The samples.
+   * @return The standard error of the mean divided by the mean.
+   */
+  static double relativeError( const std::vector<double>& samples )
+  {
+    double mean     ;
+    double variance ;
+
+    mean     = 0.0 ;
+    variance = 0.0 ;
+
+    for( double sample : samples ) mean += sample ;
+    mean /= samples.size() ;
+
+    for( double sample : samples ) variance += ( sample - mean ) * ( sample - mean ) ;
+    variance /= ( samples.size() - 1 ) ;
+
+    if( mean <= 0.0 ) return 0.0 ;
+
+    return std::sqrt( variance / samples.size() ) / mean ;
+  }
+
+  /** Structure to contain a complexity class a sweep can be fitted to.
+   */
+  struct Model
+  {
+    unsigned complexity              ; ///< The value of the class's Complexity.
+    double   ( *grow )( double size ) ; ///< The function the class grows with.
+  };
+
+  /** The complexity classes sweeps are fitted to, simplest first.
+   */
+  static const Model MODELS[] =
+  {
+    { Complexity::Constant    , []( double      ) { return 1.0                        ; } },
+    { Complexity::Logarithmic , []( double size ) { return std::log2( size )          ; } },
+    { Complexity::Linear      , []( double size ) { return size                       ; } },
+    { Complexity::Linearithmic, []( double size ) { return size * std::log2( size )   ; } },
+    { Complexity::Quadratic   , []( double size ) { return size * size                ; } },
+  };
+
+  /** Function to find the median of a set of values.
+   * @param values The values, reordered by this call.
+   * @return The median, or the upper of the two middle values for an even amount.
+   */
+  static double median( std::vector<double>& values )
+  {
+    std::nth_element( values.begin(), values.begin() + values.size() / 2, values.end() ) ;
+    return values[ values.size() / 2 ] ;
+  }
+
+  /** Function to grow a loop's iteration count until a single sample takes long enough to time, and keep running it until warmed up.
+   * @param loop The loop to warm up.
+   * @return The amount of iterations each sample should time.
+   */
+  static std::uint64_t warmup( const Loop& loop )
+  {
+    std::uint64_t iterations ;
+    double        elapsed    ;
+    double        time       ;
+
+    iterations = 1   ;
+    elapsed    = 0.0 ;
+    while( true )
+    {
+      time     = timeLoop( loop, iterations ) ;
+      elapsed += time                         ;
+
+      if( time >= SAMPLE_TIME )
+      {
+        if( elapsed >= WARMUP_TIME ) break ;
+      }
+      else if( time <= 0.0 )
+      {
+        iterations *= 10 ;
+      }
+      else
+      {
+        iterations = std::max<std::uint64_t>( iterations + 1, static_cast<std::uint64_t>( iterations * std::min( 10.0, 1.2 * SAMPLE_TIME / time ) ) ) ;
+      }
+    }
+
+    return iterations ;
+  }
+
+  /** Function to compare the samples of a variant to the samples of the baseline.
+   * @param baseline The per-iteration samples of the baseline.
+   * @param variant The per-iteration samples of the variant.
+   * @return The speedup of the variant over the baseline, with its bootstrapped confidence interval.
+   */
+  static Comparison bootstrap( const std::vector<double>& baseline, const std::vector<double>& variant )
+  {
+    std::mt19937_64     random( BOOTSTRAP_SEED ) ;
+    std::vector<double> first                    ;
+    std::vector<double> second                   ;
+    std::vector<double> speedups                 ;
+    Comparison          comparison               ;
+    double              slower                   ;
+
+    comparison = Comparison() ;
+    if( baseline.empty() || variant.empty() ) return comparison ;
+
+    std::uniform_int_distribution<std::size_t> pickFirst ( 0, baseline.size() - 1 ) ;
+    std::uniform_int_distribution<std::size_t> pickSecond( 0, variant .size() - 1 ) ;
+
+    first .resize( baseline.size() ) ;
+    second.resize( variant .size() ) ;
+    speedups.reserve( BOOTSTRAP_RESAMPLES ) ;
+
+    for( unsigned resample = 0; resample < BOOTSTRAP_RESAMPLES; resample++ )
+    {
+      for( auto& value : first  ) value = baseline[ pickFirst ( random ) ] ;
+      for( auto& value : second ) value = variant [ pickSecond( random ) ] ;
+
+      slower = median( second ) ;
+      if( slower > 0.0 ) speedups.push_back( median( first ) / slower ) ;
+    }
+
+    first  = baseline ;
+    second = variant  ;
+    slower = median( second ) ;
+
+    if( speedups.empty() || slower <= 0.0 ) return comparison ;
+
+    std::sort( speedups.begin(), speedups.end() ) ;
+
+    comparison.speedup    = median( first ) / slower                                ;
+    comparison.lower      = percentile( speedups.data(), speedups.size(), 0.025 ) ;
+    comparison.upper      = percentile( speedups.data(), speedups.size(), 0.975 ) ;
+    comparison.conclusive = comparison.lower > 1.0 || comparison.upper < 1.0       ;
+
+    return comparison ;
+  }
+
+  Statistics summarize( double* samples, unsigned count, std::uint64_t iterations )
+  {
+    Statistics stats ;
+    double     sum   ;
+
+    stats            = Statistics() ;
+    stats.iterations = iterations   ;
+    stats.samples    = count        ;
+
+    if( count == 0 ) return stats ;
+
+    std::sort( samples, samples + count ) ;
+
+    sum = 0.0 ;
+    for( unsigned index = 0; index < count; index++ ) sum += samples[ index ] ;
+
+    stats.min    = samples[ 0 ]                         ;
+    stats.median = percentile( samples, count, 0.50 )   ;
+    stats.p90    = percentile( samples, count, 0.90 )   ;
+    stats.p99    = percentile( samples, count, 0.99 )   ;
+    stats.mean   = sum / count                          ;
+
+    sum = 0.0 ;
+    for( unsigned index = 0; index < count; index++ ) sum += ( samples[ index ] - stats.mean ) * ( samples[ index ] - stats.mean ) ;
+
+    stats.stddev = count > 1 ? std::sqrt( sum / ( count - 1 ) ) : 0.0 ;
+
+    return stats ;
+  }
+
+  const char* timerName()
+  {
+    return timer().tsc ? "tsc" : "chrono" ;
+  }
+
+  Statistics measure( const Loop& loop, const Loop& empty )
+  {
+    std::vector<double> samples    ;
+    std::vector<double> idle       ;
+    Statistics          stats      ;
+    std::uint64_t       iterations ;
+    double              overhead   ;
+    double              elapsed    ;
+    double              time       ;
+
+    iterations = warmup( loop ) ;
+
+    // The empty loop is timed between samples over as many iterations, so it pays the same timer, call and loop per
+    // sample, under the same drift in the machine's speed. Samples stay whole until then, so their mean is never near zero.
+    elapsed = 0.0 ;
+    samples.reserve( MAX_SAMPLES ) ;
+    idle   .reserve( MAX_SAMPLES ) ;
+    while( samples.size() < MAX_SAMPLES )
+    {
+      time     = timeLoop( loop, iterations ) ;
+      elapsed += time                         ;
+      samples.push_back( time / iterations ) ;
+      idle   .push_back( timeLoop( empty, iterations ) / iterations ) ;
+
+      if( samples.size() >= MIN_SAMPLES && relativeError( samples ) < STABLE_ERROR ) break ;
+      if( samples.size() >= 3           && elapsed >= MAX_TIME                     ) break ;
+    }
+
+    overhead = median( idle ) ;
+    for( double& sample : samples ) sample = std::max( 0.0, sample - overhead ) ;
+
+    stats          = summarize( samples.data(), samples.size(), iterations ) ;
+    stats.overhead = overhead                                                ;
+
+    return stats ;
+  }
+
+  void compare( const Loop* loops, unsigned count, const Loop& empty, Statistics* statistics, Comparison* comparisons )
+  {
+    std::vector<std::vector<double>> samples    ;
+    std::vector<std::vector<double>> idle       ;
+    std::vector<std::uint64_t>       iterations ;
+    double                           overhead   ;
+    unsigned                         index      ;
+    double                           elapsed    ;
+    double                           time       ;
+    bool                             stable     ;
+
+    if( count == 0 ) return ;
+
+    samples   .resize( count ) ;
+    idle      .resize( count ) ;
+    iterations.resize( count ) ;
+
+    for( index = 0; index < count; index++ )
+    {
+      iterations[ index ] = warmup( loops[ index ] ) ;
+      samples   [ index ].reserve( MAX_SAMPLES ) ;
+      idle      [ index ].reserve( MAX_SAMPLES ) ;
+    }
+
+    // Each round starts from the next variant, so none of them is always sampled right after the same one.
+    elapsed = 0.0 ;
+    for( unsigned round = 0; round < MAX_SAMPLES; round++ )
+    {
+      for( unsigned offset = 0; offset < count; offset++ )
+      {
+        index    = ( round + offset ) % count                      ;
+        time     = timeLoop( loops[ index ], iterations[ index ] ) ;
+        elapsed += time                                            ;
+        samples[ index ].push_back( time / iterations[ index ] ) ;
+        idle   [ index ].push_back( timeLoop( empty, iterations[ index ] ) / iterations[ index ] ) ;
+      }
+
+      stable = round + 1 >= MIN_ROUNDS ;
+      for( index = 0; index < count && stable; index++ ) stable = relativeError( samples[ index ] ) < STABLE_ERROR ;
+
+      if( stable                                                  ) break ;
+      if( round + 1 >= MIN_ROUNDS && elapsed >= MAX_TIME * count ) break ;
+    }
+
+    for( index = 0; index < count; index++ )
+    {
+      overhead = median( idle[ index ] ) ;
+      for( double& sample : samples[ index ] ) sample = std::max( 0.0, sample - overhead ) ;
+
+      statistics[ index ]          = summarize( samples[ index ].data(), samples[ index ].size(), iterations[ index ] ) ;
+      statistics[ index ].overhead = overhead                                                                        ;
+    }
+
+    for( index = 0; index < count; index++ )
+    {
+      comparisons[ index ] = index == 0 ? Comparison() : bootstrap( samples[ 0 ], samples[ index ] ) ;
+    }
+  }
+
+  Scaling fit( const double* sizes, const double* times, unsigned count )
+  {
+    Scaling  scaling ;
+    unsigned used    ;
+
+    scaling = Scaling() ;
+    used    = 0         ;
+    for( unsigned index = 0; index < count; index++ ) used += times[ index ] > 0.0 ? 1 : 0 ;
+    if( used < 2 ) return scaling ;
+
+    // Errors are relative to each time, so every size weighs the same and the fit follows the shape of the whole sweep
+    // instead of its largest sizes, where neighbouring classes look alike.
+    scaling.sizes = count ;
+    scaling.rms   = -1.0  ;
+    for( const Model& model : MODELS )
+    {
+      double product     = 0.0 ;
+      double square      = 0.0 ;
+      double error       = 0.0 ;
+      double coefficient ;
+      double rms         ;
+
+      for( unsigned index = 0; index < count; index++ )
+      {
+        if( times[ index ] <= 0.0 ) continue ;
+
+        const double ratio = model.grow( sizes[ index ] ) / times[ index ] ;
+        product += ratio         ;
+        square  += ratio * ratio ;
+      }
+
+      if( square <= 0.0 ) continue ;
+
+      coefficient = product / square ;
+      for( unsigned index = 0; index < count; index++ )
+      {
+        if( times[ index ] <= 0.0 ) continue ;
+
+        const double residual = 1.0 - coefficient * model.grow( sizes[ index ] ) / times[ index ] ;
+        error += residual * residual ;
+      }
+
+      rms = std::sqrt( error / used ) ;
+      if( scaling.rms >= 0.0 && rms >= scaling.rms * FIT_MARGIN ) continue ;
+
+      scaling.complexity  = model.complexity ;
+      scaling.coefficient = coefficient      ;
+      scaling.rms         = rms              ;
+    }
+
+    return scaling ;
+  }
+
+  std::vector<Contention> contend( const ThreadLoop& loop, unsigned threads, const Loop& empty )
+  {
+    std::vector<Contention> levels     ;
+    std::vector<double>     idle       ;
+    std::uint64_t           iterations ;
+    double                  overhead   ;
+    double                  single     ;
+
+    const Loop first = [&loop]( std::uint64_t iterations ) { loop( 0, iterations ) ; } ;
+
+    threads    = std::max( threads, 1u ) ;
+    iterations = 1                       ;
+    while( timeLoop( first, iterations ) < BATCH_TIME ) iterations *= 2 ;
+
+    for( unsigned run = 0; run < OVERHEAD_RUNS; run++ ) idle.push_back( timeLoop( empty, iterations ) / iterations ) ;
+
+    overhead = median( idle ) ;
+    single   = 0.0            ;
+
+    for( unsigned count = 1; levels.empty() || levels.back().threads < threads; count = count > threads / 2 ? threads : count * 2 )
+    {
+      std::vector<Lane>        lanes   ;
+      std::vector<std::thread> workers ;
+      std::vector<double>      merged  ;
+      std::atomic<unsigned>    arrived ;
+      std::atomic<bool>        stop    ;
+      Contention               level   ;
+      double                   rate    ;
+
+      // Room for every batch is made up front, so no thread reallocates its samples while the others are timed.
+      lanes.resize( count ) ;
+      for( Lane& lane : lanes )
+      {
+        lane.busy = 0.0 ;
+        lane.samples.reserve( static_cast<std::size_t>( 2.0 * CONTENTION_TIME / BATCH_TIME ) ) ;
+      }
+
+      arrived = 0     ;
+      stop    = false ;
+
+      // Every thread spins until the last one arrives, so none of them gets a head start without contention.
+      for( unsigned thread = 0; thread < count; thread++ )
+      {
+        workers.emplace_back( [&, thread]()
+        {
+          const Loop own  = [&loop, thread]( std::uint64_t iterations ) { loop( thread, iterations ) ; } ;
+          Lane&      lane = lanes[ thread ] ;
+
+          arrived++ ;
+          while( arrived.load() < count ) std::this_thread::yield() ;
+
+          while( !stop.load( std::memory_order_relaxed ) )
+          {
+            const double time = timeLoop( own, iterations ) ;
+
+            lane.busy += time ;
+            lane.samples.push_back( std::max( 0.0, time / iterations - overhead ) ) ;
+          }
+        } ) ;
+      }
+
+      while( arrived.load() < count ) std::this_thread::yield() ;
+      std::this_thread::sleep_for( std::chrono::duration<double, std::nano>( CONTENTION_TIME ) ) ;
+      stop = true ;
+
+      for( auto& worker : workers ) worker.join() ;
+
+      level            = Contention() ;
+      level.threads    = count        ;
+      for( const Lane& lane : lanes )
+      {
+        rate = lane.busy > 0.0 ? lane.samples.size() * iterations * 1e9 / lane.busy : 0.0 ;
+
+        level.rates.push_back( rate ) ;
+        level.throughput += rate ;
+        merged.insert( merged.end(), lane.samples.begin(), lane.samples.end() ) ;
+      }
+
+      if( count == 1 ) single = level.throughput ;
+
+      level.efficiency = single > 0.0 ? level.throughput / ( single * count ) : 0.0 ;
+      level.statistics = summarize( merged.data(), merged.size(), iterations )      ;
+      level.statistics.overhead = overhead ;
+
+      levels.push_back( level ) ;
+    }
+
+    return levels ;
+  }
+}
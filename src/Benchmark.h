@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATHENA_BENCHMARK_H
+#define ATHENA_BENCHMARK_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace athena
+{
+  /** Structure to contain the timing statistics of a benchmark. Every time is per iteration, in nanoseconds.
+   */
+  struct Statistics
+  {
+    double        min        ; ///< The fastest sample.
+    double        median     ; ///< The median sample.
+    double        mean       ; ///< The mean of all samples.
+    double        p90        ; ///< The 90th percentile sample.
+    double        p99        ; ///< The 99th percentile sample.
+    double        stddev     ; ///< The standard deviation of all samples.
+    double        overhead   ; ///< The timer, call and empty loop overhead subtracted from every sample.
+    std::uint64_t iterations ; ///< The amount of iterations timed by each sample.
+    unsigned      samples    ; ///< The amount of samples taken. Zero when nothing was measured.
+  };
+
+  /** Structure to contain how a variant of a benchmark compares to the benchmark's first variant.
+   */
+  struct Comparison
+  {
+    double speedup    ; ///< How many times faster than the first variant this one is, from the ratio of their medians. Zero when not compared.
+    double lower      ; ///< The lower bound of the 95% bootstrap confidence interval of the speedup.
+    double upper      ; ///< The upper bound of the 95% bootstrap confidence interval of the speedup.
+    bool   conclusive ; ///< Whether the interval excludes a speedup of 1, so the difference is more than noise.
+  };
+
+  /** Structure to contain how much work one iteration of a benchmark does, to report its throughput.
+   */
+  struct Throughput
+  {
+    std::uint64_t items ; ///< The items one iteration processes. Zero reports no item rate.
+    std::uint64_t bytes ; ///< The bytes one iteration processes. Zero reports no byte rate.
+  };
+
+  /** Structure to contain how the time of a benchmark grows with the size of its input, fitted over a sweep of sizes.
+   */
+  struct Scaling
+  {
+    unsigned complexity  ; ///< The value of the Complexity fitting the sweep best. Complexity::None when not swept.
+    double   coefficient ; ///< The time per unit of work of the fit, in nanoseconds: an iteration takes coefficient * f( n ).
+    double   rms         ; ///< The root mean square error of the fit, relative to the mean time.
+    unsigned sizes       ; ///< The amount of sizes measured.
+  };
+
+  /** Structure to contain how a benchmark performs when run on a number of threads at once.
+   */
+  struct Contention
+  {
+    unsigned            threads    ; ///< The amount of threads run at once.
+    double              throughput ; ///< The iterations per second of every thread together.
+    double              efficiency ; ///< The throughput over that of a single thread times the amount of threads. One scales perfectly.
+    Statistics          statistics ; ///< The timing statistics of an iteration, over the samples of every thread.
+    std::vector<double> rates      ; ///< The iterations per second of each thread on its own, in the order of the threads.
+  };
+
+  /** The function measured by a benchmark. Runs the benchmarked work the given amount of times.
+   */
+  typedef std::function<void( std::uint64_t iterations )> Loop ;
+
+  /** The function measured by a benchmark swept over input sizes. Runs the benchmarked work on an input of the given size the
+   * given amount of times.
+   */
+  typedef std::function<void( std::uint64_t size, std::uint64_t iterations )> SizedLoop ;
+
+  /** The function measured by a benchmark run on several threads at once. Runs the benchmarked work on the given thread,
+   * numbered from zero, the given amount of times.
+   */
+  typedef std::function<void( unsigned thread, std::uint64_t iterations )> ThreadLoop ;
+
+  /** Function to measure a benchmark loop.
+   * The loop is first run with a growing iteration count until one sample takes long enough to time reliably and the
+   * warmup time has passed. Samples of that many iterations are then taken until the mean is stable or the time limit is hit.
+   * Every sample is followed by one of the empty loop over as many iterations, and the median of those is subtracted from
+   * every sample, taking out the cost of the timer, the call and the loop itself.
+   * @param loop The loop to measure.
+   * @param empty A loop doing nothing, called the same way as the measured loop.
+   * @return The statistics of the measured samples.
+   */
+  Statistics measure( const Loop& loop, const Loop& empty ) ;
+
+  /** Function to measure several variants of a benchmark against each other.
+   * Each loop is warmed up on its own, then sampled in rounds that take one sample of every loop, starting from a different
+   * loop each round so that drift in the machine's speed is spread evenly over all of them. Every variant is compared to the
+   * first by bootstrapping the ratio of their medians. The overhead of each loop is taken out as measure does.
+   * @param loops The loops to measure. The first is the baseline the others are compared to.
+   * @param count The amount of loops.
+   * @param empty A loop doing nothing, called the same way as the measured loops.
+   * @param statistics The array to store the statistics of every loop into.
+   * @param comparisons The array to store the comparison of every loop into. The first loop's is left uncompared.
+   */
+  void compare( const Loop* loops, unsigned count, const Loop& empty, Statistics* statistics, Comparison* comparisons ) ;
+
+  /** Function to measure a loop on 1, 2, 4 and so on up to a number of threads at once.
+   * For every amount of threads, each thread waits on a spin barrier so they all start together, then times batches of
+   * iterations until the measuring time is up. The batches are long enough to time reliably on a single thread, so their
+   * statistics show how the time of an iteration, and its tail, grow with contention.
+   * @param loop The loop to measure. Called from every thread at once.
+   * @param threads The most threads to run at once. Always measured, even when it isn't a power of two.
+   * @param empty A loop doing nothing, whose median time over a batch is taken out of every batch.
+   * @return How the loop performed at every amount of threads, from one up.
+   */
+  std::vector<Contention> contend( const ThreadLoop& loop, unsigned threads, const Loop& empty ) ;
+
+  /** Function to fit the times of a sweep to the complexity classes, from O(1) to O(n^2).
+   * Each class is fitted by least squares as time = coefficient * f( n ), and the one with the smallest error wins. A faster
+   * growing class has to beat a slower growing one by a margin, so noise alone doesn't make work look worse than it is.
+   * @param sizes The sizes measured.
+   * @param times The time of an iteration at each size, in nanoseconds.
+   * @param count The amount of sizes. At least two are needed to fit anything.
+   * @return The best fit.
+   */
+  Scaling fit( const double* sizes, const double* times, unsigned count ) ;
+
+  /** Function to retrieve the name of the clock benchmarks are timed with.
+   * On x86-64 Linux with an invariant time stamp counter and rdtscp this is "tsc", read with fenced rdtsc / rdtscp and calibrated against
+   * the monotonic clock on first use. Elsewhere, or when the ATHENA_TIMER environment variable is "chrono", it is "chrono".
+   * @return The name of the clock.
+   */
+  const char* timerName() ;
+
+  /** Function to compute the statistics of a set of per-iteration samples.
+   * @param samples The samples to compute statistics of, in nanoseconds. Reordered by this call.
+   * @param count The amount of samples.
+   * @param iterations The amount of iterations each sample timed.
+   * @return The statistics of the samples.
+   */
+  Statistics summarize( double* samples, unsigned count, std::uint64_t iterations ) ;
+
+  /** Function to keep the compiler from optimizing away the computation of a value.
+   * @param value The value that must be computed.
+   */
+  template<typename TYPE>
+  inline void doNotOptimize( const TYPE& value )
+  {
+#if defined( __GNUC__ ) || defined( __clang__ )
+    __asm__ __volatile__( "" : : "r,m"( value ) : "memory" ) ;
+#else
+    static volatile const void* sink ;
+    sink = &value ;
+#endif
+  }
+
+  /** Function to keep the compiler from optimizing away the computation of a value, or assuming it is unchanged afterwards.
+   * @param value The value that must be computed.
+   */
+  template<typename TYPE>
+  inline void doNotOptimize( TYPE& value )
+  {
+#if defined( __GNUC__ ) || defined( __clang__ )
+    __asm__ __volatile__( "" : "+r,m"( value ) : : "memory" ) ;
+#else
+    static volatile void* sink ;
+    sink = &value ;
+#endif
+  }
+
+  /** Function to force every pending write to memory to happen, so the compiler can't drop stores it thinks are unused.
+   */
+  inline void clobberMemory()
+  {
+#if defined( __GNUC__ ) || defined( __clang__ )
+    __asm__ __volatile__( "" : : : "memory" ) ;
+#else
+    std::atomic_signal_fence( std::memory_order_seq_cst ) ;
+#endif
+  }
+}
+
+#endif
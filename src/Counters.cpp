@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Counters.h"
+#include <atomic>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace athena
+{
+  /** The amount of events that can be counted.
+   */
+  constexpr unsigned EVENT_COUNT = 5 ;
+
+  /** Whether counting already failed on a thread, so other threads don't try again.
+   */
+  static std::atomic<bool> unavailable( false ) ;
+
+#ifdef __linux__
+  /** Structure to contain the counters opened by a thread, as one group read and reset at once.
+   */
+  struct Group
+  {
+    int      leader            ;
+    int      fds   [ EVENT_COUNT ] ;
+    unsigned events[ EVENT_COUNT ] ;
+    unsigned count             ;
+    pid_t    owner             ;
+    bool     started           ;
+    
+    /** Default constructor.
+     */
+    Group() ;
+    
+    /** Deconstructor. Closes every counter.
+     */
+    ~Group() ;
+    
+    /** Method to open every counter the kernel allows for the calling thread.
+     * @return Whether or not at least the cycle counter could be opened.
+     */
+    bool open() ;
+    
+    /** Method to close every counter.
+     */
+    void close() ;
+  };
+
+  /** Function to open a single counter of the calling thread.
+   * @param type The type of the event.
+   * @param config The event.
+   * @param group The leader of the group to open the counter in, -1 to open a leader.
+   * @return The descriptor of the counter, or -1 if it can't be opened.
+   */
+  static int openCounter( std::uint32_t type, std::uint64_t config, int group )
+  {
+    perf_event_attr attributes = {} ;
+    
+    attributes.size           = sizeof( perf_event_attr ) ;
+    attributes.type           = type                      ;
+    attributes.config         = config                    ;
+    attributes.disabled       = group == -1 ? 1 : 0       ;
+    attributes.exclude_kernel = 1                         ;
+    attributes.exclude_hv     = 1                         ;
+    attributes.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING ;
+    
+    return static_cast<int>( syscall( SYS_perf_event_open, &attributes, 0, -1, group, 0 ) ) ;
+  }
+
+  /** Function to build the configuration of a cache read miss event.
+   * @param cache The cache to count the misses of.
+   * @return The configuration of the event.
+   */
+  static std::uint64_t cacheMiss( std::uint64_t cache )
+  {
+    return cache | ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) | ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ) ;
+  }
+
+  Group::Group()
+  {
+    this->leader  = -1    ;
+    this->count   = 0     ;
+    this->owner   = 0     ;
+    this->started = false ;
+  }
+
+  Group::~Group()
+  {
+    this->close() ;
+  }
+
+  bool Group::open()
+  {
+    const struct { std::uint32_t type ; std::uint64_t config ; unsigned event ; } events[ EVENT_COUNT ] =
+    {
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES                , Counters::Cycles       },
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS              , Counters::Instructions },
+      { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES             , Counters::BranchMisses },
+      { PERF_TYPE_HW_CACHE, cacheMiss( PERF_COUNT_HW_CACHE_L1D )    , Counters::L1Misses     },
+      { PERF_TYPE_HW_CACHE, cacheMiss( PERF_COUNT_HW_CACHE_LL  )    , Counters::LLCMisses    },
+    };
+    
+    int fd ;
+    
+    this->close() ;
+    this->owner = getpid() ;
+    
+    // Events the hardware doesn't have are left out of the group, as long as cycles can be counted.
+    for( const auto& event : events )
+    {
+      fd = openCounter( event.type, event.config, this->leader ) ;
+      if( fd < 0 && this->leader == -1 ) return false ;
+      if( fd < 0                       ) continue     ;
+      
+      if( this->leader == -1 ) this->leader = fd ;
+      this->fds   [ this->count ] = fd          ;
+      this->events[ this->count ] = event.event ;
+      this->count++ ;
+    }
+    
+    return true ;
+  }
+
+  void Group::close()
+  {
+    for( unsigned index = 0; index < this->count; index++ ) ::close( this->fds[ index ] ) ;
+    
+    this->leader  = -1    ;
+    this->count   = 0     ;
+    this->started = false ;
+  }
+
+  /** The counters of the calling thread.
+   */
+  static thread_local Group group ;
+#endif
+
+  bool startCounters()
+  {
+#ifdef __linux__
+    // A forked child inherits its parent's counters, which keep counting the parent, so it opens its own.
+    if( group.leader == -1 || group.owner != getpid() )
+    {
+      if( unavailable || !group.open() )
+      {
+        unavailable   = true  ;
+        group.started = false ;
+        return false ;
+      }
+    }
+    
+    ioctl( group.leader, PERF_EVENT_IOC_RESET , PERF_IOC_FLAG_GROUP ) ;
+    ioctl( group.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP ) ;
+    group.started = true ;
+    
+    return true ;
+#else
+    return false ;
+#endif
+  }
+
+  void stopCounters( Counters& counters, std::uint64_t iterations )
+  {
+    counters        = Counters() ;
+    counters.events = 0          ;
+    
+#ifdef __linux__
+    std::uint64_t values[ 3 + EVENT_COUNT ] ;
+    double        scale                     ;
+    double        count                     ;
+    
+    if( !group.started ) return ;
+    
+    ioctl( group.leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP ) ;
+    group.started = false ;
+    
+    // The group reads as its size, the time it was enabled and running, then one value per counter.
+    if( read( group.leader, values, sizeof( values ) ) < static_cast<ssize_t>( ( 3 + group.count ) * sizeof( std::uint64_t ) ) ) return ;
+    if( values[ 2 ] == 0 || iterations == 0 ) return ;
+    
+    // When the PMU is shared, the group only ran part of the time and its counts are scaled up to the whole.
+    scale = static_cast<double>( values[ 1 ] ) / static_cast<double>( values[ 2 ] ) / static_cast<double>( iterations ) ;
+    
+    for( unsigned index = 0; index < group.count; index++ )
+    {
+      count = static_cast<double>( values[ 3 + index ] ) * scale ;
+      
+      switch( group.events[ index ] )
+      {
+        case Counters::Cycles       : counters.cycles        = count ; break ;
+        case Counters::Instructions : counters.instructions  = count ; break ;
+        case Counters::BranchMisses : counters.branch_misses = count ; break ;
+        case Counters::L1Misses     : counters.l1_misses     = count ; break ;
+        case Counters::LLCMisses    : counters.llc_misses    = count ; break ;
+        default                     :                                  break ;
+      };
+      
+      counters.events |= group.events[ index ] ;
+    }
+#else
+    static_cast<void>( iterations ) ;
+#endif
+  }
+
+  double instructionsPerCycle( const Counters& counters )
+  {
+    const unsigned needed = Counters::Cycles | Counters::Instructions ;
+    
+    if( ( counters.events & needed ) != needed || counters.cycles <= 0.0 ) return 0.0 ;
+    return counters.instructions / counters.cycles ;
+  }
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATHENA_COUNTERS_H
+#define ATHENA_COUNTERS_H
+
+#include <cstdint>
+
+namespace athena
+{
+  /** Structure to contain the hardware performance counters of a test or benchmark. Every count is per iteration.
+   */
+  struct Counters
+  {
+    /** Flags of the events that can be counted.
+     */
+    enum
+    {
+      Cycles       = 1 << 0,
+      Instructions = 1 << 1,
+      BranchMisses = 1 << 2,
+      L1Misses     = 1 << 3,
+      LLCMisses    = 1 << 4,
+    };
+    
+    unsigned events        ; ///< The flags of the events that were counted. Zero when nothing was counted.
+    double   cycles        ; ///< The amount of CPU cycles.
+    double   instructions  ; ///< The amount of instructions retired.
+    double   branch_misses ; ///< The amount of mispredicted branches.
+    double   l1_misses     ; ///< The amount of L1 data cache read misses.
+    double   llc_misses    ; ///< The amount of last level cache read misses.
+  };
+
+  /** Function to start counting hardware events on the calling thread.
+   * Counters are opened the first time a thread counts, and stay open until it exits. Only available on Linux, when the
+   * kernel lets this process use perf events ( see /proc/sys/kernel/perf_event_paranoid ).
+   * @return Whether or not the counters were started.
+   */
+  bool startCounters() ;
+
+  /** Function to stop counting hardware events on the calling thread, started with startCounters.
+   * @param counters Reference to the counters to fill out.
+   * @param iterations The amount of iterations the counts are divided by.
+   */
+  void stopCounters( Counters& counters, std::uint64_t iterations ) ;
+
+  /** Function to compute the instructions retired per cycle of a set of counters.
+   * @param counters The counters.
+   * @return The instructions per cycle, or zero when either count is missing.
+   */
+  double instructionsPerCycle( const Counters& counters ) ;
+}
+
+#endif
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Fixture.h"
+#include <mutex>
+#include <vector>
+
+namespace athena
+{
+  struct SuiteData
+  {
+    std::mutex         lock      ;
+    std::vector<void*> idle      ;
+    void*              shared    ;
+    Sharing            sharing   ;
+    unsigned           remaining ;
+    unsigned           leased    ;
+
+    /** Default constructor.
+     */
+    SuiteData() ;
+  };
+
+  /** Function to extract a name from a sharing.
+   * @param sharing The sharing to recieve a name from.
+   * @return The name of the sharing.
+   */
+  const char* nameFromSharing( Sharing sharing )
+  {
+    switch( sharing.value() )
+    {
+      case Sharing::Shared :
+        return "Shared" ;
+      case Sharing::Worker :
+        return "Worker" ;
+      default:
+        return "Unknown" ;
+    };
+  }
+
+  SuiteData::SuiteData()
+  {
+    this->shared    = nullptr ;
+    this->remaining = 0       ;
+    this->leased    = 0       ;
+  }
+
+  Sharing::Sharing()
+  {
+    this->enumeration = Sharing::Shared ;
+  }
+
+  Sharing::Sharing( unsigned sharing )
+  {
+    this->enumeration = sharing ;
+  }
+
+  Sharing::operator unsigned() const
+  {
+    return this->enumeration ;
+  }
+
+  Sharing& Sharing::operator=( unsigned sharing )
+  {
+    this->enumeration = sharing ;
+    
+    return *this ;
+  }
+
+  const char* Sharing::name() const
+  {
+    return nameFromSharing( *this ) ;
+  }
+
+  void Sharing::set( unsigned sharing )
+  {
+    this->enumeration = sharing ;
+  }
+
+  unsigned Sharing::value() const
+  {
+    return this->enumeration ;
+  }
+
+  Suite::Lease::Lease( Suite& suite )
+  {
+    this->suite    = &suite           ;
+    this->instance = suite.acquire() ;
+  }
+
+  Suite::Lease::~Lease()
+  {
+    this->suite->release( this->instance ) ;
+  }
+
+  void* Suite::Lease::get() const
+  {
+    return this->instance ;
+  }
+
+  Suite::Suite( const Sharing& sharing )
+  {
+    this->suite_data = new SuiteData() ;
+    
+    data().sharing = sharing ;
+  }
+
+  Suite::~Suite()
+  {
+    delete this->suite_data ;
+  }
+
+  void Suite::expect( unsigned count )
+  {
+    std::lock_guard<std::mutex> guard( data().lock ) ;
+    
+    data().remaining += count ;
+  }
+
+  void Suite::teardown()
+  {
+    std::vector<void*> idle ;
+    
+    {
+      std::lock_guard<std::mutex> guard( data().lock ) ;
+      
+      data().remaining = 0 ;
+      if( data().leased != 0 ) return ;
+      
+      idle.swap( data().idle ) ;
+      if( data().shared != nullptr ) idle.push_back( data().shared ) ;
+      data().shared = nullptr ;
+    }
+    
+    for( auto instance : idle ) this->destroy( instance ) ;
+  }
+
+  Sharing Suite::sharing() const
+  {
+    return data().sharing ;
+  }
+
+  void* Suite::acquire()
+  {
+    void* instance ;
+    
+    if( data().sharing.value() == Sharing::Shared )
+    {
+      // Every test waits on the first one to set the instance up, so none of them sees it half-built.
+      std::lock_guard<std::mutex> guard( data().lock ) ;
+      
+      if( data().shared == nullptr ) data().shared = this->construct() ;
+      data().leased++ ;
+      
+      return data().shared ;
+    }
+    
+    {
+      std::lock_guard<std::mutex> guard( data().lock ) ;
+      
+      data().leased++ ;
+      if( !data().idle.empty() )
+      {
+        instance = data().idle.back() ;
+        data().idle.pop_back() ;
+        
+        return instance ;
+      }
+    }
+    
+    // Workers set up their own instances at the same time.
+    return this->construct() ;
+  }
+
+  void Suite::release( void* instance )
+  {
+    std::lock_guard<std::mutex> guard( data().lock ) ;
+    
+    data().leased-- ;
+    if( data().sharing.value() == Sharing::Worker ) data().idle.push_back( instance ) ;
+    if( data().remaining != 0 && --data().remaining != 0 ) return ;
+    if( data().leased != 0 ) return ;
+    
+    for( auto idle : data().idle ) this->destroy( idle ) ;
+    if( data().shared != nullptr ) this->destroy( data().shared ) ;
+    
+    data().idle.clear() ;
+    data().shared = nullptr ;
+  }
+
+  SuiteData& Suite::data()
+  {
+    return *this->suite_data ;
+  }
+
+  const SuiteData& Suite::data() const
+  {
+    return *this->suite_data ;
+  }
+}
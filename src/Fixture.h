@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATHENA_FIXTURE_H
+#define ATHENA_FIXTURE_H
+
+namespace athena
+{
+  /** Class to handle how the tests of a suite share its fixture.
+   */
+  class Sharing
+  {
+    public:
+      
+      /** Enumeration for this object.
+       */
+      enum
+      {
+        Shared,
+        Worker
+      };
+      
+      /** Default constructor.
+       */
+      Sharing() ;
+      
+      /** Copy constructor
+       * @param sharing The input to copy into this object.
+       */
+      Sharing( unsigned sharing ) ;
+      
+      /** Conversion operator to convert this sharing to an unsigned integer.
+       * @return An unsigned integer representation of this object.
+       */
+      operator unsigned() const ;
+      
+      /** Assignment operator. Assigns this object to the input.
+       * @param sharing The unsigned integer to assign this sharing to.
+       * @return Reference to this object after assignment.
+       */
+      Sharing& operator=( unsigned sharing ) ;
+      
+      /** Method to retrieve the string name of this sharing.
+       * @return C-string representation of this object's name.
+       */
+      const char* name() const ;
+      
+      /** Method to set this object's value.
+       * @param sharing The unsigned integer to set this object to.
+       */
+      void set( unsigned sharing ) ;
+      
+      /** Method to retrieve the value of this object.
+       * @return The unsigned-integer representation of this object.
+       */
+      unsigned value() const ;
+    private:
+      
+      /** The internal enumeration of this object.
+       */
+      unsigned enumeration ;
+  };
+
+  /** Class to manage the instances of a suite's fixture, independent of the fixture's type.
+   * Instances are only set up once a test of the suite runs, and are torn down once the suite's last scheduled test is
+   * done. A shared suite gives every test the same instance, which must then be safe to use from several threads. A
+   * worker suite keeps a pool of instances and lends each running test its own, so it never sets up more instances than
+   * there are tests running at once.
+   */
+  class Suite
+  {
+    public:
+      
+      /** Class to borrow an instance of a suite for as long as a test runs.
+       */
+      class Lease
+      {
+        public:
+          
+          /** Constructor. Borrows an instance, setting one up if none are free.
+           * @param suite The suite to borrow from.
+           */
+          explicit Lease( Suite& suite ) ;
+          
+          /** Deconstructor. Gives the instance back, and tears the suite down if this was its last scheduled test.
+           */
+          ~Lease() ;
+          
+          /** Method to retrieve the borrowed instance.
+           * @return Pointer to the instance.
+           */
+          void* get() const ;
+          
+          Lease( const Lease& lease ) = delete ;
+          
+          Lease& operator=( const Lease& lease ) = delete ;
+        private:
+          Suite* suite    ;
+          void*  instance ;
+      };
+      
+      /** Constructor.
+       * @param sharing How the tests of the suite share its fixture.
+       */
+      explicit Suite( const Sharing& sharing ) ;
+      
+      /** Default deconstructor. Deriving classes must tear the suite down themselves.
+       */
+      virtual ~Suite() ;
+      
+      /** Method to schedule more tests of this suite in the current run.
+       * @param count The amount of tests to schedule.
+       */
+      void expect( unsigned count = 1 ) ;
+      
+      /** Method to tear down every instance no test is using, and stop waiting for tests that never ran.
+       * Instances still used by abandoned tests are torn down once they are given back.
+       */
+      void teardown() ;
+      
+      /** Method to retrieve how the tests of this suite share its fixture.
+       * @return How the tests of this suite share its fixture.
+       */
+      Sharing sharing() const ;
+      
+      Suite( const Suite& suite ) = delete ;
+      
+      Suite& operator=( const Suite& suite ) = delete ;
+    protected:
+      
+      /** Method to set up a new instance of the fixture.
+       * @return Pointer to the new instance.
+       */
+      virtual void* construct() = 0 ;
+      
+      /** Method to tear down an instance of the fixture.
+       * @param instance Pointer to the instance to tear down.
+       */
+      virtual void destroy( void* instance ) = 0 ;
+    private:
+      
+      /** Method to borrow an instance, setting one up if none are free.
+       * @return Pointer to the instance.
+       */
+      void* acquire() ;
+      
+      /** Method to give back an instance once its test is done.
+       * @param instance Pointer to the instance to give back.
+       */
+      void release( void* instance ) ;
+      
+      /** Forward-declared structure to contain this object's internal data.
+       */
+      struct SuiteData *suite_data ;
+      
+      /** Method to retrieve a reference to this object's internal data.
+       * @return Reference to this object's internal data.
+       */
+      SuiteData& data() ;
+      
+      /** Method to retrieve a const reference to this object's internal data.
+       * @return Const-reference to this object's internal data.
+       */
+      const SuiteData& data() const ;
+  };
+
+  /** Class to contain the fixture of a suite: a default-constructible type set up and torn down by the suite.
+   * The fixture must outlive every run of the managers its tests are added to.
+   */
+  template<typename TYPE>
+  class Fixture : public Suite
+  {
+    public:
+      
+      /** Constructor.
+       * @param sharing How the tests of the suite share the fixture.
+       */
+      explicit Fixture( const Sharing& sharing = Sharing::Shared ) ;
+      
+      /** Deconstructor. Tears down every instance left.
+       */
+      ~Fixture() ;
+    protected:
+      
+      void* construct() override ;
+      
+      void destroy( void* instance ) override ;
+  };
+
+  template<typename TYPE>
+  Fixture<TYPE>::Fixture( const Sharing& sharing ) : Suite( sharing )
+  {
+  }
+
+  template<typename TYPE>
+  Fixture<TYPE>::~Fixture()
+  {
+    this->teardown() ;
+  }
+
+  template<typename TYPE>
+  void* Fixture<TYPE>::construct()
+  {
+    return new TYPE() ;
+  }
+
+  template<typename TYPE>
+  void Fixture<TYPE>::destroy( void* instance )
+  {
+    delete static_cast<TYPE*>( instance ) ;
+  }
+}
+
+#endif
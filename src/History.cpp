@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "History.h"
+#include <fstream>
+#include <stdio.h>
+
+#ifdef __linux__
+#include <sys/stat.h>
+#endif
+
+namespace athena
+{
+  /** The first line of every history file.
+   */
+  constexpr const char* HISTORY_HEADER = "# athena history 1" ;
+
+  /** The amount of tab-separated fields following the name on each line.
+   */
+  constexpr unsigned HISTORY_FIELDS = 3 ;
+
+  bool saveHistory( const char* path, const HistoryMap& history )
+  {
+    FILE* file ;
+
+    file = fopen( path, "w" ) ;
+    if( !file ) return false ;
+
+    fprintf( file, "%s\n", HISTORY_HEADER ) ;
+    for( const auto& entry : history )
+    {
+      fprintf( file, "%s\t%016llx\t%u\t%.17g\n", entry.first.c_str(), static_cast<unsigned long long>( entry.second.fingerprint ),
+               entry.second.result, entry.second.time ) ;
+    }
+
+    return fclose( file ) == 0 ;
+  }
+
+  bool loadHistory( const char* path, HistoryMap& history )
+  {
+    std::ifstream      file        ;
+    std::string        line        ;
+    History            entry       ;
+    size_t             split       ;
+    unsigned long long fingerprint ;
+    int                read        ;
+
+    file.open( path ) ;
+    if( !file ) return false ;
+
+    if( !std::getline( file, line ) || line != HISTORY_HEADER ) return false ;
+
+    while( std::getline( file, line ) )
+    {
+      // The name may hold tabs itself, so it is everything before the last HISTORY_FIELDS fields.
+      split = line.size() ;
+      for( unsigned field = 0; field < HISTORY_FIELDS && split != std::string::npos && split != 0; field++ )
+      {
+        split = line.rfind( '\t', split - 1 ) ;
+      }
+
+      if( split == std::string::npos || split == 0 ) continue ;
+
+      read = sscanf( line.c_str() + split + 1, "%llx\t%u\t%lg", &fingerprint, &entry.result, &entry.time ) ;
+      if( read != static_cast<int>( HISTORY_FIELDS ) ) continue ;
+
+      entry.fingerprint                  = fingerprint ;
+      history[ line.substr( 0, split ) ] = entry       ;
+    }
+
+    return true ;
+  }
+
+  std::uint64_t fingerprintProgram()
+  {
+#ifdef __linux__
+    struct stat   status      ;
+    std::uint64_t fingerprint ;
+
+    if( stat( "/proc/self/exe", &status ) != 0 ) return 0 ;
+
+    // FNV-1a over the fields that change when the executable is rebuilt.
+    fingerprint = 14695981039346656037ull ;
+    for( std::uint64_t field : { static_cast<std::uint64_t>( status.st_size ), static_cast<std::uint64_t>( status.st_ino ),
+                                 static_cast<std::uint64_t>( status.st_mtim.tv_sec ), static_cast<std::uint64_t>( status.st_mtim.tv_nsec ) } )
+    {
+      for( unsigned byte = 0; byte < sizeof( field ); byte++ )
+      {
+        fingerprint ^= ( field >> ( byte * 8 ) ) & 0xff ;
+        fingerprint *= 1099511628211ull ;
+      }
+    }
+
+    return fingerprint != 0 ? fingerprint : 1 ;
+#else
+    return 0 ;
+#endif
+  }
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATHENA_HISTORY_H
+#define ATHENA_HISTORY_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace athena
+{
+  /** Structure to contain how a test did the last time it ran.
+   */
+  struct History
+  {
+    std::uint64_t fingerprint ; ///< The fingerprint of the program the test last ran in.
+    unsigned      result      ; ///< The value of the test's last result. The worst of its cases for a parameterized test.
+    double        time        ; ///< The time the test last took, in microseconds. The total of its cases for a parameterized test.
+  };
+
+  /** Map of test names to how they did the last time they ran.
+   */
+  typedef std::map<std::string, History> HistoryMap ;
+
+  /** Function to save a history to a file.
+   * @param path The path of the file to write.
+   * @param history The history to save.
+   * @return Whether or not the file could be written.
+   */
+  bool saveHistory( const char* path, const HistoryMap& history ) ;
+
+  /** Function to load a history from a file, on top of whatever the map already holds.
+   * @param path The path of the file to read.
+   * @param history Reference to the history to load into.
+   * @return Whether or not the file could be read.
+   */
+  bool loadHistory( const char* path, HistoryMap& history ) ;
+
+  /** Function to compute a fingerprint of the running program, which changes whenever the program is rebuilt.
+   * Built from the size, modification time and inode of the executable, so it costs a single stat call.
+   * @return The fingerprint, or zero when the program's file can't be found.
+   */
+  std::uint64_t fingerprintProgram() ;
+}
+
+#endif
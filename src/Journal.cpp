@@ -0,0 +1,396 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Journal.h"
+#include <algorithm>
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
+#include <vector>
+
+#ifdef __unix__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace athena
+{
+  /** The first bytes of every journal.
+   */
+  constexpr char JOURNAL_MAGIC[ 8 ] = { 'a', 't', 'h', 'e', 'n', 'a', 'j', '2' } ;
+
+  /** The value written last into every entry, once the rest of it is complete.
+   */
+  constexpr std::uint32_t ENTRY_SEAL = 0x5ea1ed01u ;
+
+  /** The alignment of every entry. Entries are padded up to it, so the next one starts aligned too.
+   */
+  constexpr std::size_t ENTRY_ALIGN = 8 ;
+
+  /** The room made for the name and contention of an entry when a journal is opened, on top of its fixed part.
+   */
+  constexpr std::size_t ENTRY_EXTRA = 64 ;
+
+  /** The flags of an entry.
+   */
+  constexpr std::uint32_t ENTRY_COMPARED   = 1u << 0 ;
+  constexpr std::uint32_t ENTRY_REGRESSION = 1u << 1 ;
+
+  /** Structure at the start of every journal.
+   */
+  struct Header
+  {
+    char          magic[ 8 ] ; ///< JOURNAL_MAGIC.
+    std::uint32_t entry      ; ///< The size of an entry's fixed part, so a journal of another layout is refused.
+    std::uint32_t level      ; ///< The size of a contention level's fixed part, for the same reason.
+    std::uint32_t finished   ; ///< Whether the run finished, set as the journal is closed.
+    std::uint32_t reserved   ; ///< Zero. Keeps the first entry aligned.
+  };
+
+  /** Structure to contain the fixed part of the record of one test in a journal.
+   * It's followed by the entry's contention levels, each followed by the throughput of its threads, then the test's name.
+   */
+  struct Entry
+  {
+    std::uint32_t seal        ; ///< ENTRY_SEAL once the entry is complete, zero before.
+    std::uint32_t size        ; ///< The size of the whole entry, padded to ENTRY_ALIGN.
+    std::uint32_t result      ; ///< The value of the test's result.
+    std::uint32_t reason      ; ///< The value of the reason of the test's result.
+    std::int32_t  code        ; ///< The signal or exit code of a crashed test.
+    std::uint32_t flags       ; ///< The ENTRY_ flags of the test.
+    double        time        ; ///< The time the test took, in microseconds.
+    double        delta       ; ///< The relative change of the test's time against its baseline.
+    Statistics    statistics  ;
+    Counters      counters    ;
+    Allocations   allocations ;
+    Comparison    comparison  ;
+    Throughput    throughput  ;
+    Scaling       scaling     ;
+    Repetition    repetition  ;
+    std::uint32_t levels      ; ///< The amount of contention levels following the fixed part.
+    std::uint32_t length      ; ///< The length of the name following the levels, without a terminator.
+  };
+
+  /** Structure to contain the fixed part of a contention level in a journal, followed by the throughput of each of its threads.
+   */
+  struct Level
+  {
+    std::uint32_t threads    ;
+    std::uint32_t rates      ; ///< The amount of thread throughputs following the fixed part.
+    double        throughput ;
+    double        efficiency ;
+    Statistics    statistics ;
+  };
+
+  static_assert( std::is_trivially_copyable<Entry>::value && std::is_trivially_copyable<Level>::value, "Journal entries are copied as they are" ) ;
+  static_assert( sizeof( Header ) % ENTRY_ALIGN == 0 && sizeof( Entry ) % ENTRY_ALIGN == 0 && sizeof( Level ) % ENTRY_ALIGN == 0, "Journal entries must stay aligned" ) ;
+
+  /** Function to round a size up to the alignment of an entry.
+   * @param size The size to round up.
+   * @return The size, padded to ENTRY_ALIGN.
+   */
+  static std::size_t pad( std::size_t size )
+  {
+    return ( size + ENTRY_ALIGN - 1 ) / ENTRY_ALIGN * ENTRY_ALIGN ;
+  }
+
+  struct JournalData
+  {
+    int         fd       ;
+    void*       mapping  ;
+    std::size_t capacity ;
+    std::size_t used     ;
+
+    /** Default constructor.
+     */
+    JournalData() ;
+
+    /** Method to map the journal file with room for a size, growing the file to fit.
+     * @param size The size of the file to make room for, in bytes.
+     * @return Whether or not the file could be grown and mapped.
+     */
+    bool map( std::size_t size ) ;
+
+    /** Method to retrieve the header of the mapped journal.
+     * @return Reference to the header.
+     */
+    Header& header() ;
+
+    /** Method to retrieve a position of the mapped journal.
+     * @param offset The offset of the position from the start of the file.
+     * @return Pointer to the position.
+     */
+    char* at( std::size_t offset ) ;
+  };
+
+  JournalData::JournalData()
+  {
+    this->fd       = -1      ;
+    this->mapping  = nullptr ;
+    this->capacity = 0       ;
+    this->used     = 0       ;
+  }
+
+  bool JournalData::map( std::size_t size )
+  {
+#ifdef __unix__
+    void* mapped ;
+
+    if( ftruncate( this->fd, static_cast<off_t>( size ) ) != 0 ) return false ;
+
+    mapped = mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0 ) ;
+    if( mapped == MAP_FAILED ) return false ;
+
+    if( this->mapping != nullptr ) munmap( this->mapping, this->capacity ) ;
+
+    this->mapping  = mapped ;
+    this->capacity = size   ;
+
+    return true ;
+#else
+    static_cast<void>( size ) ;
+    return false ;
+#endif
+  }
+
+  Header& JournalData::header()
+  {
+    return *static_cast<Header*>( this->mapping ) ;
+  }
+
+  char* JournalData::at( std::size_t offset )
+  {
+    return static_cast<char*>( this->mapping ) + offset ;
+  }
+
+  Journal::Journal()
+  {
+    this->journal_data = new JournalData() ;
+  }
+
+  Journal::~Journal()
+  {
+    this->close() ;
+    delete this->journal_data ;
+  }
+
+  bool Journal::open( const char* path, unsigned capacity )
+  {
+    this->close() ;
+
+#ifdef __unix__
+    data().fd = ::open( path, O_RDWR | O_CREAT | O_TRUNC, 0644 ) ;
+    if( data().fd < 0 ) return false ;
+
+    if( !data().map( sizeof( Header ) + std::max( capacity, 1u ) * ( sizeof( Entry ) + ENTRY_EXTRA ) ) )
+    {
+      ::close( data().fd ) ;
+      data().fd = -1 ;
+      return false ;
+    }
+
+    memcpy( data().header().magic, JOURNAL_MAGIC, sizeof( JOURNAL_MAGIC ) ) ;
+    data().header().entry    = sizeof( Entry  ) ;
+    data().header().level    = sizeof( Level  ) ;
+    data().header().finished = 0                ;
+    data().header().reserved = 0                ;
+    data().used              = sizeof( Header ) ;
+
+    return true ;
+#else
+    static_cast<void>( path     ) ;
+    static_cast<void>( capacity ) ;
+    return false ;
+#endif
+  }
+
+  bool Journal::append( const std::string& name, const Record& record )
+  {
+    std::size_t size   ;
+    std::size_t offset ;
+    Entry       entry  ;
+    Level       level  ;
+
+    if( !this->opened() ) return false ;
+
+    size = sizeof( Entry ) + name.size() ;
+    for( const Contention& contention : record.contention ) size += sizeof( Level ) + contention.rates.size() * sizeof( double ) ;
+    size = pad( size ) ;
+
+    if( data().used + size > data().capacity && !data().map( std::max( data().capacity * 2, data().used + size ) ) ) return false ;
+
+    entry             = Entry()                            ;
+    entry.size        = static_cast<std::uint32_t>( size ) ;
+    entry.result      = record.result.value()              ;
+    entry.reason      = record.reason.value()              ;
+    entry.code        = record.code                        ;
+    entry.time        = record.time                        ;
+    entry.delta       = record.delta                       ;
+    entry.statistics  = record.statistics                  ;
+    entry.counters    = record.counters                    ;
+    entry.allocations = record.allocations                 ;
+    entry.comparison  = record.comparison                  ;
+    entry.throughput  = record.throughput                  ;
+    entry.scaling     = record.scaling                     ;
+    entry.repetition  = record.repetition                  ;
+    entry.levels      = record.contention.size()           ;
+    entry.length      = name.size()                        ;
+    entry.flags       = ( record.compared   ? ENTRY_COMPARED   : 0 ) |
+                        ( record.regression ? ENTRY_REGRESSION : 0 ) ;
+
+    // Everything but the seal is written first, and the space past the last entry is still zero, so a crash part way
+    // through an entry leaves it unsealed instead of half written.
+    offset = data().used + sizeof( Entry ) ;
+    for( const Contention& contention : record.contention )
+    {
+      level            = Level()                                    ;
+      level.threads    = contention.threads                         ;
+      level.rates      = contention.rates.size()                    ;
+      level.throughput = contention.throughput                      ;
+      level.efficiency = contention.efficiency                      ;
+      level.statistics = contention.statistics                      ;
+
+      memcpy( data().at( offset ), &level, sizeof( Level ) ) ;
+      if( !contention.rates.empty() ) memcpy( data().at( offset + sizeof( Level ) ), contention.rates.data(), contention.rates.size() * sizeof( double ) ) ;
+      offset += sizeof( Level ) + contention.rates.size() * sizeof( double ) ;
+    }
+
+    memcpy( data().at( offset ), name.data(), name.size() ) ;
+    memcpy( data().at( data().used ), &entry, sizeof( Entry ) ) ;
+
+    std::atomic_thread_fence( std::memory_order_release ) ;
+    reinterpret_cast<Entry*>( data().at( data().used ) )->seal = ENTRY_SEAL ;
+
+    data().used += size ;
+    return true ;
+  }
+
+  void Journal::close()
+  {
+#ifdef __unix__
+    if( !this->opened() ) return ;
+
+    data().header().finished = 1 ;
+    munmap( data().mapping, data().capacity ) ;
+
+    if( ftruncate( data().fd, static_cast<off_t>( data().used ) ) != 0 ) perror( "athena: Unable to trim the journal" ) ;
+    ::close( data().fd ) ;
+
+    data().fd       = -1      ;
+    data().mapping  = nullptr ;
+    data().capacity = 0       ;
+    data().used     = 0       ;
+#endif
+  }
+
+  bool Journal::opened() const
+  {
+    return data().mapping != nullptr ;
+  }
+
+  JournalData& Journal::data()
+  {
+    return *this->journal_data ;
+  }
+
+  const JournalData& Journal::data() const
+  {
+    return *this->journal_data ;
+  }
+
+  bool loadJournal( const char* path, RecordMap& records, bool& finished )
+  {
+    FILE*             file   ;
+    Header            header ;
+    Entry             entry  ;
+    Level             level  ;
+    Record            record ;
+    Contention        contention ;
+    std::vector<char> rest   ;
+    std::size_t       offset ;
+    bool              valid  ;
+
+    file = fopen( path, "rb" ) ;
+    if( !file ) return false ;
+
+    if( fread( &header, sizeof( Header ), 1, file ) != 1 || memcmp( header.magic, JOURNAL_MAGIC, sizeof( JOURNAL_MAGIC ) ) != 0 ||
+        header.entry != sizeof( Entry ) || header.level != sizeof( Level ) )
+    {
+      fclose( file ) ;
+      return false ;
+    }
+
+    // Entries are appended in order, so the first one left unsealed ends what the run got to journal.
+    finished = header.finished != 0 ;
+    while( fread( &entry, sizeof( Entry ), 1, file ) == 1 && entry.seal == ENTRY_SEAL && entry.size >= sizeof( Entry ) )
+    {
+      rest.resize( entry.size - sizeof( Entry ) ) ;
+      if( !rest.empty() && fread( rest.data(), rest.size(), 1, file ) != 1 ) break ;
+
+      record             = Record()                                 ;
+      record.result      = Result( entry.result )                   ;
+      record.reason      = entry.reason                             ;
+      record.code        = entry.code                               ;
+      record.time        = entry.time                               ;
+      record.delta       = entry.delta                              ;
+      record.compared    = ( entry.flags & ENTRY_COMPARED   ) != 0 ;
+      record.regression  = ( entry.flags & ENTRY_REGRESSION ) != 0 ;
+      record.statistics  = entry.statistics                         ;
+      record.counters    = entry.counters                           ;
+      record.allocations = entry.allocations                        ;
+      record.comparison  = entry.comparison                         ;
+      record.throughput  = entry.throughput                         ;
+      record.scaling     = entry.scaling                            ;
+      record.repetition  = entry.repetition                         ;
+
+      // Every count read from the entry is checked against its size, so a damaged entry ends the journal instead of the reader.
+      offset = 0    ;
+      valid  = true ;
+      for( std::uint32_t index = 0; index < entry.levels && valid; index++ )
+      {
+        valid = offset + sizeof( Level ) <= rest.size() ;
+        if( !valid ) break ;
+
+        memcpy( &level, rest.data() + offset, sizeof( Level ) ) ;
+        offset += sizeof( Level ) ;
+
+        valid = level.rates <= ( rest.size() - offset ) / sizeof( double ) ;
+        if( !valid ) break ;
+
+        contention            = Contention()     ;
+        contention.threads    = level.threads    ;
+        contention.throughput = level.throughput ;
+        contention.efficiency = level.efficiency ;
+        contention.statistics = level.statistics ;
+        contention.rates.resize( level.rates ) ;
+        if( level.rates != 0 ) memcpy( contention.rates.data(), rest.data() + offset, level.rates * sizeof( double ) ) ;
+        offset += level.rates * sizeof( double ) ;
+
+        record.contention.push_back( contention ) ;
+      }
+
+      if( !valid || entry.length > rest.size() - offset ) break ;
+
+      records[ std::string( rest.data() + offset, entry.length ) ] = record ;
+    }
+
+    fclose( file ) ;
+    return true ;
+  }
+}
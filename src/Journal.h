@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATHENA_JOURNAL_H
+#define ATHENA_JOURNAL_H
+
+#include "Record.h"
+
+namespace athena
+{
+  /** Class to append the record of every finished test to a binary journal, written through a memory-mapped file.
+   * Every record is an entry holding all of its fields and the test's full name, sealed once complete. Written pages belong
+   * to the kernel right away, so every sealed entry survives the process crashing or being killed part way through a run, though not the machine going down.
+   */
+  class Journal
+  {
+    public:
+
+      /** Default constructor.
+       */
+      Journal() ;
+
+      /** Default deconstructor. Closes the journal if it is still open.
+       */
+      ~Journal() ;
+
+      /** Method to start a new journal, replacing the file if it exists.
+       * @param path The path of the journal file.
+       * @param capacity The amount of records to make room for. The file grows when more are appended.
+       * @return Whether or not the file could be created and mapped.
+       */
+      bool open( const char* path, unsigned capacity ) ;
+
+      /** Method to append the record of a finished test, growing the file when it's full.
+       * @param name The name of the test.
+       * @param record The record of the test.
+       * @return Whether or not the record was journaled.
+       */
+      bool append( const std::string& name, const Record& record ) ;
+
+      /** Method to mark the run as finished and close the journal, cutting the file down to the records it holds.
+       */
+      void close() ;
+
+      /** Method to retrieve whether this journal is open.
+       * @return Whether or not records are being journaled.
+       */
+      bool opened() const ;
+    private:
+
+      /** Forward-declared structure to contain this object's internal data.
+       */
+      struct JournalData *journal_data ;
+
+      /** Method to retrieve a reference to this object's internal data.
+       * @return Reference to this object's internal data.
+       */
+      JournalData& data() ;
+
+      /** Method to retrieve a const reference to this object's internal data.
+       * @return Const-reference to this object's internal data.
+       */
+      const JournalData& data() const ;
+  };
+
+  /** Function to load the records of a journal, adding them to a map. Tests already in the map are overwritten.
+   * Reads every sealed entry, so the journal of a run that crashed still gives the tests that finished before it did.
+   * @param path The path of the journal to read.
+   * @param records The map to add the journal's records to.
+   * @param finished Reference to set to whether the journaled run finished.
+   * @return Whether or not the file is a journal, and could be read.
+   */
+  bool loadJournal( const char* path, RecordMap& records, bool& finished ) ;
+}
+
+#endif
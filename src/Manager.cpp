@@ -33,36 +33,72 @@
  */
 
 #include "Manager.h"
+#include "History.h"
+#include "Journal.h"
+#include "Pool.h"
+#include "Record.h"
+#include "Reporter.h"
 #include <map>
+#include <set>
+#include <vector>
 #include <string>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string>
 #include <chrono>
 #include <iostream>
 #include <tuple>
 #include <iomanip>
+#include <thread>
+#include <cmath>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <algorithm>
+#include <cstring>
+
+#ifdef __unix__
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 namespace athena
 {
-#if defined ( __unix__ ) || defined( _WIN32 )
-  constexpr const char* END_COLOR   = "\x1B[m"     ;
-  constexpr const char* COLOR_GREEN = "\u001b[32m" ;
-  constexpr const char* COLOR_GREY  = "\x1B[1;30m" ;
-  constexpr const char* COLOR_RED   = "\u001b[31m" ;
-  constexpr const char* COLOR_WHITE = "\u001b[1m"  ;
-  constexpr const char* UNDERLINE   = "\u001b[4m"  ;
-#else
-  constexpr const char* END_COLOR   = "" ;
-  constexpr const char* COLOR_GREEN = "" ;
-  constexpr const char* COLOR_GREY  = "" ;
-  constexpr const char* COLOR_RED   = "" ;
-  constexpr const char* COLOR_WHITE = "" ;
-#endif
+  /** The amount of standard errors two benchmark medians must differ by to count as a regression.
+   */
+  constexpr double NOISE_SIGMAS = 3.0 ;
+  
+  /** The difference in microseconds a single-sample test must exceed to count as a regression, to ignore clock jitter.
+   */
+  constexpr double TEST_NOISE = 10.0 ;
   
   /** Alias for a chrono time point since that name is super long.
    */
   typedef std::chrono::steady_clock::time_point TimePoint ;
 
+  /** Function to hash a test name with 64-bit FNV-1a, so it maps to the same shard on every platform and run.
+   * @param name The name to hash.
+   * @return The hash of the name.
+   */
+  std::uint64_t hashName( const char* name )
+  {
+    std::uint64_t hash ;
+    
+    hash = 0xcbf29ce484222325ull ;
+    for( ; *name != '\0'; name++ )
+    {
+      hash ^= static_cast<unsigned char>( *name ) ;
+      hash *= 0x00000100000001b3ull              ;
+    }
+    
+    return hash ;
+  }
+
   /** Function to get a name from a result.
    * @param result The result to convert to a name
    * @return The name of the result.
@@ -77,30 +113,19 @@ namespace athena
         return "Fail" ;
       case Result::Skip :
         return "Skip" ;
+      case Result::Crash :
+        return "Crash" ;
+      case Result::Timeout :
+        return "Timeout" ;
+      case Result::NotRun :
+        return "NotRun" ;
+      case Result::Flaky :
+        return "Flaky" ;
       default:
         return "Unknown" ;
     };
   }
   
-  /** Function to obtain a color from a test result.
-   * @param result The result to retrieve a color for.
-   * @return A color representing the result.
-   */
-  const char* colorFromResult( Result result )
-  {
-    switch( result.value() )
-    {
-      case Result::Pass :
-        return COLOR_GREEN ;
-      case Result::Fail :
-        return COLOR_RED ;
-      case Result::Skip :
-        return COLOR_GREY ;
-      default:
-        return COLOR_RED ;
-    };
-  }
-  
   /** Function to obtain a symbol from a result.
    * @param result The result to pull a symbol from.
    * @return The symbol representation of the result.
@@ -111,10 +136,16 @@ namespace athena
     {
       case Result::Pass :
         return " ✔ " ;
-      case Result::Fail :
+      case Result::Fail    :
+      case Result::Crash   :
+      case Result::Timeout :
         return " ✗ " ;
       case Result::Skip :
         return " ■ " ;
+      case Result::NotRun :
+        return " ○ " ;
+      case Result::Flaky :
+        return " ~ " ;
       default:
         return "???" ;
     };
@@ -139,306 +170,2548 @@ namespace athena
     };
   }
 
-  struct ManagerData
-  {
-    typedef std::tuple<Result, double>                TestResult  ;
-    typedef std::map<std::string, TestResult>         ResultMap   ;
-    typedef std::map<std::string, Manager::Callback*> CallbackMap ;
-    
-    CallbackMap callbacks    ;
-    ResultMap   results      ;
-    std::string program_name ;
-
-    /** Method to print the Athena header.
-     */
-    void printHeader() const ;
-
-    /** Method to process test results.
-     */
-    unsigned processResults( Output output ) ;
-
-    /** Method to print the test information.
-     * @param result The rest result.
-     * @param output The output type.
-     * @param last Whether or not this is the last test.
-     */
-    void printTest( std::string name, double time, Result result, Output output, bool last ) ;
-    
-    /** Method to print the test summary.
-     * @param passed The amount of passed tests.
-     * @param failed The amount of failed tests.
-     * @param skipped The amount of skipped tests.
-     * @param total_time The total time to test all tests.
-     * @param output The output type.
-     */
-    void printSummary( unsigned passed, unsigned failed, unsigned skipped, double total_time, Output output ) ;
-  };
-  
-  void ManagerData::printHeader() const
-  {
-    std::cout << "\n" ;
-    std::cout << COLOR_WHITE << std::string( 60, '-' ) << "\n" ;
-    std::cout << COLOR_WHITE << " ATHENA: " << this->program_name ;
-    std::cout << COLOR_WHITE << std::string( 50 - this->program_name.size(), ' ' ) << "|\n" ;
-    std::cout << COLOR_WHITE << std::string( 60, '-' ) << "\n" ;
-    std::cout << END_COLOR ;
-  }
-  
-  unsigned ManagerData::processResults( Output output )
+  /** Function to extract a name from a reason.
+   * @param reason The reason to recieve a name from.
+   * @return The name of the reason.
+   */
+  const char* nameFromReason( Reason reason )
   {
-    unsigned    num_passed  ;
-    unsigned    num_skipped ;
-    unsigned    num_failed  ;
-    unsigned    total_tests ;
-    unsigned    count       ;
-    double      time        ;
-    double      total_time  ;
-    Result      result      ;
-    std::string name        ;
-    
-    total_time  = 0.0 ;
-    num_passed  = 0   ;
-    num_skipped = 0   ;
-    num_failed  = 0   ;
-    total_tests = 0   ;
-    count       = 0   ;
-    
-    this->printHeader() ;
-    for( const auto& res : this->results )
+    switch( reason.value() )
     {
-      name   = res.first ;
-      result = std::get<0>( res.second ) ;
-      time   = std::get<1>( res.second ) ;
-      
-      total_time += time ;
-      
-      switch( result.value() )
-      {
-        case Result::Fail :
-          num_failed++  ;
-          total_tests++ ;
-          break ;
-        case Result::Pass :
-          num_passed++  ;
-          total_tests++ ;
-          break ;
-        case Result::Skip :
-          num_skipped++ ;
-          break ;
-        default :
-          break ;
-      };
-      
-      count++ ;
-      this->printTest( name, time, result, output, count == this->results.size() ) ;
-    }
-    
-    this->printSummary( num_passed, num_failed, num_skipped, total_time, output ) ;
-
-    return num_failed ;
+      case Reason::None :
+        return "None" ;
+      case Reason::Signal :
+        return "Signal" ;
+      case Reason::Exit :
+        return "Exit" ;
+      case Reason::Regression :
+        return "Regression" ;
+      case Reason::Deadline :
+        return "Deadline" ;
+      case Reason::Budget :
+        return "Budget" ;
+      case Reason::Complexity :
+        return "Complexity" ;
+      default:
+        return "Unknown" ;
+    };
   }
   
-  void ManagerData::printTest( std::string name, double time, Result result, Output output, bool last )
+  /** Function to extract a name from a rerun.
+   * @param rerun The rerun to recieve a name from.
+   * @return The name of the rerun.
+   */
+  const char* nameFromRerun( Rerun rerun )
   {
-    const std::string separator = last ? "└─" : "├─" ;
-    if( output.value() != Output::Quiet )
+    switch( rerun.value() )
     {
-      std::cout << colorFromResult( result ) << std::left << "--|" << result.symbol() << result.name() << " " ;
-
-      if( output.value() == Output::Verbose && result.value() != Result::Skip )
-      {
-        if( time < 1000.0 )
-        {
-          std::cout << std::right << std::setw( 6 ) << std::setfill('0') << std::setprecision( 2 ) << std::fixed << time << "μs" ;
-        }
-        else
-        {
-          std::cout << std::right << std::setw( 6 ) << std::setfill('0') << std::setprecision( 2 ) << std::fixed << time / 1000.0 << "ms" ;
-        }
-      }
-      else if( result.value() == Result::Skip )
-      {
-        std::cout << "NONE" << std::setw( 4 ) << std::setfill(' ') << " " ;
-      }
-      
-      std::cout << std::left << " " << separator << " " << name << " " ;
-      std::cout << END_COLOR                                    ;
-      if( !last ) std::cout << "\n"                             ;
-    }
+      case Rerun::All :
+        return "All" ;
+      case Rerun::FailedFirst :
+        return "FailedFirst" ;
+      case Rerun::OnlyFailed :
+        return "OnlyFailed" ;
+      case Rerun::SkipPassed :
+        return "SkipPassed" ;
+      default:
+        return "Unknown" ;
+    };
   }
-  
-  void ManagerData::printSummary( unsigned passed, unsigned failed, unsigned skipped, double total_time, Output output )
+
+  /** Function to parse a rerun from its name on the command line.
+   * @param text The name, one of all, failed-first, only-failed or skip-passed.
+   * @param rerun Reference to the rerun to set.
+   * @return Whether or not the name is known.
+   */
+  bool rerunFromName( const char* text, Rerun& rerun )
   {
-    unsigned total = passed + failed ;
-    std::cout << std::endl ;
-    std::cout << std::endl ;
+    const char* names[] = { "all", "failed-first", "only-failed", "skip-passed" } ;
     
-    const char* color = passed == total ? COLOR_GREEN : COLOR_RED ;
-    std::cout << color << "  Test Results: " << END_COLOR << "\n"                              ;
-    std::cout << color << "     ├─Passed : " << passed  << " / " << total << END_COLOR << "\n" ;
-    std::cout << color << "     ├─Failed : " << failed  << " / " << total << END_COLOR << "\n" ;
-    std::cout << color << "     └─Skipped: " << skipped <<                   END_COLOR << "\n" ;
-    
-    if( output.value() == output.Verbose )
+    for( unsigned index = 0; index < 4; index++ )
     {
-      if( total_time >= 1000.0 )
-      std::cout << COLOR_WHITE << "\n  Total Elapsed Time : " << std::setprecision( 5 ) << total_time / 1000 << "ms" << END_COLOR << std::endl ;
-      else
-      std::cout << COLOR_WHITE << "\n  Total Elapsed Time : " << std::setprecision( 5 ) << total_time << "μs" << END_COLOR << std::endl ;
+      if( strcmp( text, names[ index ] ) != 0 ) continue ;
+      
+      rerun = index ;
+      return true ;
     }
     
-    std::cout << COLOR_WHITE << std::string( 60, '-' ) << END_COLOR << "\n" << std::endl ;
+    return false ;
   }
 
-  Result::Result()
+  /** Function to check whether a result counts as a failure.
+   * @param result The value of the result.
+   * @return Whether or not the result failed, crashed or timed out.
+   */
+  bool isFailure( unsigned result )
   {
-    this->enumeration = Result::Skip ;
+    return result == Result::Fail || result == Result::Crash || result == Result::Timeout ;
   }
 
-  Result::Result( const Result& result )
+  /** The result of a test in the history of a run before any of its cases was reported.
+   */
+  constexpr unsigned UNSEEN = ~0u ;
+
+  /** Function to extract a name from an isolation.
+   * @param isolation The isolation to recieve a name from.
+   * @return The name of the isolation.
+   */
+  const char* nameFromIsolation( Isolation isolation )
   {
-    this->enumeration = result.enumeration ;
+    switch( isolation.value() )
+    {
+      case Isolation::None :
+        return "None" ;
+      case Isolation::Process :
+        return "Process" ;
+      default:
+        return "Unknown" ;
+    };
   }
 
-  Result::Result( unsigned result )
+  /** Function to extract a name from a complexity.
+   * @param complexity The complexity to recieve a name from.
+   * @return The name of the complexity, in big O notation.
+   */
+  const char* nameFromComplexity( Complexity complexity )
   {
-    this->enumeration = result ;
+    switch( complexity.value() )
+    {
+      case Complexity::None :
+        return "None" ;
+      case Complexity::Constant :
+        return "O(1)" ;
+      case Complexity::Logarithmic :
+        return "O(log n)" ;
+      case Complexity::Linear :
+        return "O(n)" ;
+      case Complexity::Linearithmic :
+        return "O(n log n)" ;
+      case Complexity::Quadratic :
+        return "O(n^2)" ;
+      default:
+        return "Unknown" ;
+    };
   }
 
-  Result& Result::operator=( const Result& result )
+#ifdef __unix__
+  /** Structure to contain the message a child process sends back over its pipe.
+   */
+  struct Message
   {
-    this->enumeration = result.enumeration ;
-    
-    return *this ;
-  }
+    unsigned    result      ;
+    double      time        ;
+    Counters    counters    ;
+    Allocations allocations ;
+    Repetition  repetition  ;
+  };
+  
+  /** Structure to contain a running child process.
+   */
+  struct Child
+  {
+    pid_t     pid   ;
+    int       fd    ;
+    unsigned  task  ;
+    TimePoint begin ;
+  };
+#endif
 
-  Result& Result::operator=( unsigned result )
+  /** Function to create the record of a test that timed out.
+   * @param time The time the test ran for before timing out, in microseconds.
+   * @param deadline Whether the test was stopped by the run's deadline rather than its own timeout.
+   * @return The record of the timed out test.
+   */
+  Record timedOut( double time, bool deadline )
   {
-    this->enumeration = result ;
+    Record record ;
     
-    return *this ;
+    record        = Record() ;
+    record.time   = time     ;
+    record.reason = deadline ? Reason::Deadline : Reason::None ;
+    record.result.set( Result::Timeout ) ;
+    
+    return record ;
   }
 
-  Result& Result::operator=( bool result )
+  /** Function to retrieve a loop running a benchmark that does nothing, built and called the same way as every registered
+   * benchmark, so timing it costs exactly what a benchmark pays besides its own body.
+   * @return The empty loop.
+   */
+  const Loop& emptyLoop()
   {
-    this->enumeration = result ;
+    static Arena      arena                   ;
+    static Callable   empty( []() {}, arena ) ;
+    static Callable*  callback = &empty       ;
+    static const Loop loop     = []( std::uint64_t iterations ) { callback->run( iterations ) ; } ;
     
-    return *this ;
+    return loop ;
   }
 
-  const char* Result::name() const
+  /** Function to create the record of a test that never started because the run stopped.
+   * @return The record of the test.
+   */
+  Record notRun()
   {
-    return nameFromResult( *this ) ;
+    Record record ;
+    
+    record = Record() ;
+    record.result.set( Result::NotRun ) ;
+    
+    return record ;
   }
 
-  const char* Result::symbol() const
+  /** Structure to point the calling thread's cancellation at the test it runs, for as long as it lives.
+   */
+  struct Token
   {
-    return symbolFromResult( *this ) ;
-  }
-
-  void Result::set( unsigned result )
+    const std::atomic<bool>*     stopping ; ///< Whether the run is stopping.
+    const std::atomic<unsigned>* stored   ; ///< The next case of the test's batch without a stored outcome, or nullptr.
+    unsigned                     item     ; ///< The case of the test. Its outcome is already stored, as when it timed out, once stored is past it.
+    
+    /** Constructor.
+     * @param stopping The flag set when the run stops.
+     * @param stored The next case of the test's batch without a stored outcome, or nullptr.
+     * @param item The case of the test.
+     */
+    Token( const std::atomic<bool>* stopping, const std::atomic<unsigned>* stored, unsigned item ) ;
+    
+    /** Deconstructor. Detaches the calling thread from the test.
+     */
+    ~Token() ;
+  };
+  
+  /** The token of the test running on each thread, if any.
+   */
+  static thread_local const Token* current_token = nullptr ;
+  
+  Token::Token( const std::atomic<bool>* stopping, const std::atomic<unsigned>* stored, unsigned item )
   {
-    this->enumeration = result ;
+    this->stopping = stopping ;
+    this->stored   = stored   ;
+    this->item     = item     ;
+    current_token  = this     ;
   }
-
-  Result::operator unsigned() const
+  
+  Token::~Token()
   {
-    return this->enumeration ;
+    current_token = nullptr ;
   }
 
-  Result::operator bool() const
+  bool cancelled()
   {
-    return static_cast<bool>( this->enumeration == 1 ? true : false ) ;
+    if( current_token == nullptr ) return false ;
+    
+    return *current_token->stopping || ( current_token->stored != nullptr && *current_token->stored > current_token->item ) ;
   }
 
-  unsigned Result::value() const
-  {
-    return this->enumeration ;
-  }
-  
-  Output::Output( unsigned output_type )
+  /** Structure to contain a single include or exclude filter over test names.
+   */
+  struct Filter
   {
-    this->enumeration = output_type ;
-  }
+    /** The kinds of pattern a filter can hold.
+     */
+    enum
+    {
+      Glob,
+      Regex,
+      Tag
+    };
+    
+    unsigned    kind    ; ///< The kind of pattern.
+    std::string pattern ; ///< The pattern, without its kind's prefix.
+    std::string prefix  ; ///< The literal prefix every matching name starts with.
+    std::regex  regex   ; ///< The compiled pattern of a regex filter.
+  };
 
-  Output::operator unsigned() const
+  /** Function to match a name against a glob pattern, where '*' matches any run of characters and '?' any single one.
+   * @param pattern The glob pattern.
+   * @param name The name to match.
+   * @return Whether or not the whole name matches the pattern.
+   */
+  bool matchGlob( const char* pattern, const char* name )
   {
-    return this->enumeration ;
+    const char* star  ;
+    const char* retry ;
+    
+    star  = nullptr ;
+    retry = nullptr ;
+    while( *name != '\0' )
+    {
+      if( *pattern == '*' )
+      {
+        star  = ++pattern ;
+        retry = name      ;
+      }
+      else if( *pattern == '?' || *pattern == *name )
+      {
+        pattern++ ;
+        name++    ;
+      }
+      else if( star != nullptr )
+      {
+        // Let the last star swallow one more character and try again from there.
+        pattern = star    ;
+        name    = ++retry ;
+      }
+      else
+      {
+        return false ;
+      }
+    }
+    
+    while( *pattern == '*' ) pattern++ ;
+    return *pattern == '\0' ;
   }
 
-  Output& Output::operator=( unsigned output_type )
+  /** Function to find the literal prefix every name matching a regex must start with.
+   * @param pattern The regex, which matches whole names.
+   * @return The literal prefix, empty when the regex can start with anything.
+   */
+  std::string prefixOfRegex( const std::string& pattern )
   {
-    this->enumeration = output_type ;
+    std::string prefix ;
+    size_t      index  ;
     
-    return *this ;
+    if( pattern.find( '|' ) != std::string::npos ) return prefix ;
+    
+    for( index = pattern.size() != 0 && pattern[ 0 ] == '^' ? 1 : 0; index < pattern.size(); index++ )
+    {
+      if( strchr( ".[]()*+?{}|^$\\", pattern[ index ] ) != nullptr ) break ;
+      prefix += pattern[ index ] ;
+    }
+    
+    // A quantifier that allows zero repetitions makes the last literal optional.
+    if( index < pattern.size() && strchr( "*?{", pattern[ index ] ) != nullptr && !prefix.empty() ) prefix.pop_back() ;
+    
+    return prefix ;
   }
 
-  const char* Output::name() const
+  /** Function to build a filter from its text.
+   * @param text The filter: a glob, "re:" followed by a regex matching whole names, or "tag:" followed by a tag.
+   * @param filter Reference to the filter to fill out.
+   * @return Whether or not the filter is valid.
+   */
+  bool makeFilter( const char* text, Filter& filter )
   {
-    return nameFromOutput( *this ) ;
+    const std::string pattern = text ;
+    
+    if( pattern.compare( 0, 3, "re:" ) == 0 )
+    {
+      filter.kind    = Filter::Regex        ;
+      filter.pattern = pattern.substr( 3 ) ;
+      filter.prefix  = prefixOfRegex( filter.pattern ) ;
+      
+      try
+      {
+        filter.regex = std::regex( filter.pattern, std::regex::ECMAScript | std::regex::optimize ) ;
+      }
+      catch( const std::regex_error& )
+      {
+        return false ;
+      }
+    }
+    else if( pattern.compare( 0, 4, "tag:" ) == 0 )
+    {
+      filter.kind    = Filter::Tag          ;
+      filter.pattern = pattern.substr( 4 ) ;
+    }
+    else
+    {
+      filter.kind    = Filter::Glob                                      ;
+      filter.pattern = pattern                                           ;
+      filter.prefix  = pattern.substr( 0, pattern.find_first_of( "*?" ) ) ;
+    }
+    
+    return !filter.pattern.empty() ;
   }
 
-  void Output::set( unsigned output_type )
+  /** The most cases of a parameterized test a worker takes from the pool at once.
+   */
+  constexpr unsigned CASE_BATCH = 64 ;
+
+  /** Structure to contain a single task of a run: a plain test, a benchmark, or a batch of cases of a parameterized test.
+   * A batch is only a range of cases, so a parameterized test costs a task per batch however many cases it has.
+   */
+  struct Test
   {
-    this->enumeration = output_type ;
-  }
+    Callable* callable ; ///< The callable of the test.
+    unsigned  index    ; ///< The index of the test in the registry.
+    unsigned  first    ; ///< The index of the batch's first case, zero for a plain test.
+    unsigned  count    ; ///< The amount of cases in the batch, one for a plain test.
+  };
 
-  unsigned Output::value() const
+  /** Structure to contain how far every task of a run got, and everything a running test reads.
+   * Shared with the run's workers, so a test abandoned by the watchdog can't outlive what it reads or writes to.
+   */
+  struct Outcomes
   {
-    return this->enumeration ;
+    std::unique_ptr<std::atomic<unsigned>[]> stored   ; ///< The next case of every task without a stored outcome.
+    std::vector<double>                       times    ; ///< The time every task's cases took together, in microseconds.
+    std::mutex                                lock     ; ///< Held while a case is claimed for good, or a worker calls back into the manager.
+    std::atomic<bool>                         stopping ; ///< Whether the run is stopping, once it reached the most failures allowed.
+    unsigned                                  repeat   ; ///< The amount of times every test is run.
+    unsigned                                  retries  ; ///< The most times a test is rerun while every run of it failed.
+    bool                                      counters ; ///< Whether to count the hardware events of every test.
+    
+    /** Constructor.
+     * @param tests Every task of the run.
+     * @param repeat The amount of times every test is run.
+     * @param retries The most times a test is rerun while every run of it failed.
+     * @param counters Whether to count the hardware events of every test.
+     */
+    Outcomes( const std::vector<Test>& tests, unsigned repeat, unsigned retries, bool counters ) ;
+    
+    /** Method to claim the outcome of a task's next case, unless it already has one.
+     * @param task The index of the task.
+     * @param item The case of the task, the next one without an outcome.
+     * @return Whether or not the case's outcome is this caller's to report.
+     */
+    bool store( unsigned task, unsigned item ) ;
+  };
+  
+  Outcomes::Outcomes( const std::vector<Test>& tests, unsigned repeat, unsigned retries, bool counters )
+  {
+    this->stored.reset( new std::atomic<unsigned>[ tests.size() ] ) ;
+    this->times.assign( tests.size(), 0.0 ) ;
+    this->stopping = false                  ;
+    this->repeat   = std::max( repeat, 1u ) ;
+    this->retries  = retries                ;
+    this->counters = counters               ;
+    
+    for( unsigned task = 0; task < tests.size(); task++ ) this->stored[ task ] = tests[ task ].first ;
   }
   
-  Manager::Manager()
+  bool Outcomes::store( unsigned task, unsigned item )
   {
-    this->manager_data = new ManagerData() ;
+    // Only the case a batch is at can be claimed, so a case the watchdog already gave up on stays reported as it was.
+    return this->stored[ task ].compare_exchange_strong( item, item + 1 ) ;
   }
 
-  Manager::~Manager()
+  /** Structure to contain the allocation budget of a test.
+   */
+  struct Budget
   {
-    delete this->manager_data ;
-  }
-  
-  void Manager::initialize( const char* program_name )
+    std::uint64_t allocations ; ///< The most allocations the test may make.
+    std::uint64_t bytes       ; ///< The most bytes the test may have allocated at once.
+  };
+
+  /** Structure to contain the sizes a benchmark is swept over.
+   */
+  struct Sweep
   {
-    data().program_name = program_name ;
-  }
+    std::uint64_t min  ; ///< The smallest size to measure.
+    std::uint64_t max  ; ///< The largest size to measure.
+    SizedLoop     loop ; ///< The loop running the benchmark on an input of a size.
+  };
 
-  unsigned Manager::size() const
+  /** Structure to contain the threads a benchmark is run on at once.
+   */
+  struct Contender
   {
-    return data().callbacks.size() ;
-  }
+    unsigned   threads ; ///< The most threads to run at once. Zero uses every hardware thread.
+    ThreadLoop loop    ; ///< The loop running the benchmark on a thread.
+  };
 
-  unsigned Manager::test( const Output& output )
+  struct ManagerData
   {
-    TimePoint begin  ;
-    TimePoint end    ;
-    double    time   ;
-    Result    result ;
-    
-    for( auto& cb : data().callbacks )
-    {
-      begin  = std::chrono::steady_clock::now() ;
-      result = cb.second->test() ;
-      end    = std::chrono::steady_clock::now() ;
-      
-      if( result.value() == Result::Skip )
-      {
-        time = 0.0 ;
-      }
-      else
-      {
-        time = std::chrono::duration<double, std::micro>( end - begin ).count() ;
-      }
-      
-      data().results.insert( { cb.first, std::make_tuple( result, time ) } ) ;
-    }
+    typedef std::set<std::string>                  NameSet      ;
+    typedef std::map<std::string, NameSet>         TagMap       ;
+    typedef std::map<std::string, Suite*>          SuiteMap     ;
+    typedef std::map<std::string, std::string>     GroupMap     ;
+    typedef std::vector<std::string>               NameList     ;
+    typedef std::map<std::string, NameList>        VariantMap   ;
+    typedef std::vector<Filter>                    FilterList   ;
+    typedef std::map<std::string, double>          TimeMap      ;
+    typedef std::map<std::string, Budget>          BudgetMap    ;
+    typedef std::map<std::string, Sweep>           SweepMap     ;
+    typedef std::map<std::string, Contender>       ContenderMap ;
+    typedef std::map<std::string, Throughput>      RateMap      ;
+    typedef std::map<std::string, Complexity>      GrowthMap    ;
+    typedef std::vector<Test>                      TestList     ;
+    typedef std::vector<Reporter*>                 ReporterList ;
+    typedef std::vector<std::unique_ptr<Reporter>> FormatList   ;
+    typedef std::pair<unsigned, unsigned>          Turn         ;
+    typedef std::map<Turn, Record>                 PendingMap   ;
     
-    return data().processResults( output ) ;
+    Registry                 registry     ;
+    FilterList               includes     ;
+    FilterList               excludes     ;
+    TagMap                   tags         ;
+    SuiteMap                 suites       ;
+    GroupMap                 groups       ;
+    VariantMap               variants     ;
+    std::vector<unsigned>    selection    ;
+    std::shared_ptr<TestList> tests       ;
+    RecordMap                results      ; ///< The records loaded from result files and journals. Runs keep none.
+    RecordMap                baseline     ;
+    double                   threshold    ;
+    bool                     regressions  ;
+    unsigned                 shard        ;
+    unsigned                 shards       ;
+    NameSet                  serial       ;
+    TimeMap                  timeouts     ;
+    double                   timeout      ;
+    double                   deadline     ;
+    Isolation                isolation    ;
+    bool                     counters     ;
+    BudgetMap                budgets      ;
+    Budget                   budget       ;
+    SweepMap                 sweeps       ;
+    ContenderMap             contenders   ;
+    RateMap                  throughputs  ;
+    GrowthMap                complexities ;
+    std::string              history_path ;
+    std::string              journal_path ;
+    Journal                  journal      ;
+    HistoryMap               history      ;
+    std::vector<History>     latest       ;
+    std::uint64_t            fingerprint  ;
+    Rerun                    rerun        ;
+    unsigned                 max_failures ;
+    unsigned                 failures     ;
+    unsigned                 repeat       ;
+    unsigned                 retries      ;
+    std::string              program_name ;
+    FormatList               formats      ;
+    Console*                 console      ;
+    ReporterList             reporters    ;
+    ReporterList             active       ;
+    std::mutex               lock         ;
+    Summary                  summary      ;
+    std::string              saved        ; ///< The result file lines of every test last reported, all save needs of them.
+    std::vector<unsigned>    order        ; ///< Every scheduled task, in the order its cases are reported in.
+    std::vector<unsigned>    rank         ; ///< The position of every task in the order.
+    PendingMap               pending      ; ///< The records that finished before their turn, by position and case.
+    unsigned                 cursor       ; ///< The position in the order of the next task to report.
+    unsigned                 next         ; ///< The next case of that task to report.
+
+    /** Default constructor.
+     */
+    ManagerData() ;
+
+    /** Method to run a single test and time it.
+     * @param test The test to run.
+     * @param item The case of the test to run.
+     * @param counters Whether to count the hardware events of the test, if the platform allows it.
+     * @return The result, time and counters of the test.
+     */
+    static Record execute( const Test& test, unsigned item, bool counters ) ;
+
+    /** Method to run a test as many times as it's repeated, then retry it while every run so far failed.
+     * Stops early once the run stops or the test's outcome is stored without it, as when it timed out.
+     * @param test The test to run.
+     * @param item The case of the test to run.
+     * @param outcomes The outcomes of the run, holding how often to run the test.
+     * @param task The index of the test in the run.
+     * @return The outcome of the test over all of its runs. Only a single run of it when it's neither repeated nor retried.
+     */
+    static Record attempt( const Test& test, unsigned item, const Outcomes& outcomes, unsigned task ) ;
+
+    /** Method to run a benchmark callback and measure it.
+     * A benchmark's return value is only kept alive, not interpreted, so a measured benchmark always passes.
+     * @param task The index of the benchmark in the run.
+     * @return The result, total time and timing statistics of the benchmark.
+     */
+    Record benchmark( unsigned task ) const ;
+
+    /** Method to measure a benchmark at every size of its sweep, and fit how its time grows.
+     * @param task The index of the benchmark in the run.
+     * @param sweep The sizes to measure the benchmark at.
+     * @return The result, total time and scaling of the benchmark, with the timing statistics of its largest size.
+     */
+    Record sweep( unsigned task, const Sweep& sweep ) const ;
+
+    /** Method to measure a benchmark on a growing number of threads at once.
+     * @param task The index of the benchmark in the run.
+     * @param contender The threads to run the benchmark on.
+     * @return The result, total time and contention of the benchmark, with the timing statistics of a single thread.
+     */
+    Record contend( unsigned task, const Contender& contender ) const ;
+
+    /** Method to count the hardware events, allocations and throughput of a measured benchmark.
+     * @param task The index of the benchmark in the run.
+     * @param outcome The record of the benchmark, measured already, to add the counts to.
+     */
+    void profile( unsigned task, Record& outcome ) const ;
+
+    /** Method to find the variants of a benchmark that are part of a run, in the order they were added.
+     * @param task The index of the benchmark in the run.
+     * @param measured The indices of every benchmark of the run.
+     * @return The indices of the benchmark's variants, or only the benchmark's own when it has none.
+     */
+    std::vector<unsigned> siblings( unsigned task, const std::vector<unsigned>& measured ) const ;
+
+    /** Method to measure the variants of a benchmark together, and report each compared to the first.
+     * @param tasks The indices of the variants in the run, the first being the baseline.
+     * @param outcomes The outcomes to store each variant's record into.
+     */
+    void contrast( const std::vector<unsigned>& tasks, Outcomes& outcomes ) ;
+
+    /** Method to run a set of tests on a thread pool, under a watchdog if any timeout or deadline is set.
+     * The cases of a parameterized test are handed to workers in batches of up to CASE_BATCH, each batch timed as a whole.
+     * @param tests Every test of the run.
+     * @param limits The timeout of every test in milliseconds, zero for none.
+     * @param tasks The indices of the tests to run.
+     * @param outcomes The outcomes to store each case's record into.
+     * @param jobs The amount of threads to run at once.
+     * @param end The time at which the run's deadline passes.
+     */
+    void dispatch( std::shared_ptr<const TestList> tests, const std::vector<double>& limits, const std::vector<unsigned>& tasks, std::shared_ptr<Outcomes> outcomes, unsigned jobs, TimePoint end ) ;
+
+    /** Method to run a set of coroutine tests on an executor, multiplexed over @p jobs threads.
+     * @param tests Every test of the run.
+     * @param limits The timeout of every test in milliseconds, zero for none.
+     * @param tasks The indices of the tests to run.
+     * @param outcomes The outcomes to store each test's record into.
+     * @param jobs The amount of threads to run the tests on.
+     * @param end The time at which the run's deadline passes.
+     */
+    void await( const TestList& tests, const std::vector<double>& limits, const std::vector<unsigned>& tasks, Outcomes& outcomes, unsigned jobs, TimePoint end ) ;
+
+    /** Method to run a set of tests in child processes, at most @p jobs at a time.
+     * A child running past its timeout or the deadline is killed. Falls back to running in-process on platforms without fork.
+     * @param tests Every test of the run.
+     * @param limits The timeout of every test in milliseconds, zero for none.
+     * @param tasks The indices of the tests to run.
+     * @param outcomes The outcomes to store each test's record into.
+     * @param jobs The amount of child processes to run at once.
+     * @param end The time at which the run's deadline passes.
+     */
+    void spawn( const TestList& tests, const std::vector<double>& limits, const std::vector<unsigned>& tasks, Outcomes& outcomes, unsigned jobs, TimePoint end ) ;
+
+#ifdef __unix__
+    /** Method to fork a child process running a single test.
+     * @param test The test to run in the child.
+     * @param outcomes The outcomes of the run, holding how often to run the test.
+     * @param child The child to fill out, already holding the test's index.
+     * @return Whether or not the child was started.
+     */
+    bool launch( const Test& test, const Outcomes& outcomes, Child& child ) const ;
+    
+    /** Method to collect the outcome of a finished child process.
+     * @param child The child to collect.
+     * @return The outcome of the child's test.
+     */
+    Record reap( const Child& child ) const ;
+#endif
+
+    /** Method to run every test, reporting each one as it finishes.
+     * @param jobs The amount of tests to run at once.
+     */
+    void run( unsigned jobs ) ;
+
+    /** Method to compare the record of a test against the loaded baseline.
+     * @param name The name of the test.
+     * @param record The record to compare, updated with the comparison.
+     */
+    void compare( const std::string& name, Record& record ) const ;
+
+    /** Method to fail a passed test that allocated more than its budget.
+     * @param name The name of the test.
+     * @param record The record of the test, updated when it is over budget.
+     */
+    void enforce( const std::string& name, Record& record ) const ;
+
+    /** Method to add a comma-separated list of filters.
+     * @param list The filters to add.
+     * @param exclude Whether the filters exclude tests instead of including them.
+     * @return Whether every filter was valid. Invalid filters are skipped.
+     */
+    bool filter( const char* list, bool exclude ) ;
+
+    /** Method to check whether a test matches a filter.
+     * @param filter The filter to check.
+     * @param index The index of the test in the registry.
+     * @return Whether or not the test matches.
+     */
+    bool matches( const Filter& filter, unsigned index ) const ;
+
+    /** Method to select the tests of the next run from the filters, in name order.
+     * Include filters only look at the range of names sharing their literal prefix, so picking a few tests out of many is fast.
+     */
+    void select() ;
+
+    /** Method to reorder or narrow down the selected tests from the history of earlier runs.
+     */
+    void recall() ;
+
+    /** Method to order tests longest first by the time they took in the history, so no long test is left running alone at the end.
+     * Tests without a history are expected to take the median time of those with one. Ties keep their order. A batch of cases
+     * is expected to take its share of its test's time.
+     * @param tests Every test of the run.
+     * @param tasks The indices of the tests to order.
+     */
+    void schedule( const TestList& tests, std::vector<unsigned>& tasks ) const ;
+
+    /** Method to measure how well the parallel tests of a run used its workers.
+     * The ideal is the larger of the tests' total time shared evenly between the workers, and the longest single batch.
+     * @param tasks The indices of the parallel tests.
+     * @param outcomes The outcomes of the run.
+     * @param workers The amount of workers the tests ran on.
+     * @param makespan The wall time the tests took, in microseconds.
+     */
+    void utilization( const std::vector<unsigned>& tasks, const Outcomes& outcomes, unsigned workers, double makespan ) ;
+
+    /** Method to count a failed test, and stop the run once it reaches the most failures allowed.
+     * Must be called with the lock held.
+     * @param outcomes The outcomes of the run, holding whether it's stopping.
+     */
+    void tally( Outcomes& outcomes ) ;
+
+    /** Method to add the record of a test to the history of the current run.
+     * @param task The index of the test in the run.
+     * @param record The record of the test.
+     */
+    void remember( unsigned task, const Record& record ) ;
+
+    /** Method to merge the current run into the history, and save it.
+     */
+    void commit() ;
+
+    /** Method to replace the formats runs are reported in.
+     * @param list Comma-separated list of formats, each optionally followed by '=' and the path of the file to write.
+     * @return Whether every format was known and its file could be opened. Otherwise the formats are left unchanged.
+     */
+    bool format( const char* list ) ;
+
+    /** Method to start reporting a run to every reporter.
+     * @param count The amount of tests that will be reported.
+     */
+    void begin( unsigned count ) ;
+
+    /** Method to build the name a test is reported under. Cases are named after their test and index, e.g. "parse[42]".
+     * The name is only built once a case is reported, so cases cost nothing until then.
+     * @param task The index of the test in the run.
+     * @param item The case of the test.
+     * @return The name of the test.
+     */
+    std::string label( unsigned task, unsigned item ) const ;
+
+    /** Method to tell every reporter a test started running.
+     * @param task The index of the test.
+     * @param item The case of the test.
+     */
+    void started( unsigned task, unsigned item ) ;
+
+    /** Method to report a case whose outcome was just claimed, along with every case held back that is now next in the
+     * run's order. A case finishing before its turn is held until then.
+     * @param outcomes The outcomes of the run.
+     * @param task The index of the finished test.
+     * @param item The case of the test.
+     * @param record The outcome of the case.
+     */
+    void finished( Outcomes& outcomes, unsigned task, unsigned item, Record record ) ;
+
+    /** Method to store an outcome for every case of a test that doesn't have one yet, and report them.
+     * @param outcomes The outcomes of the run.
+     * @param task The index of the test.
+     * @param record The outcome of the cases.
+     * @return Whether or not any outcome was stored.
+     */
+    bool complete( Outcomes& outcomes, unsigned task, const Record& record ) ;
+
+    /** Method to add a record to the saved lines, the journal and the summary, and tell every reporter about it.
+     * @param name The name of the test.
+     * @param record The record of the test.
+     */
+    void report( const std::string& name, const Record& record ) ;
+
+    /** Method to finish reporting a run to every reporter.
+     */
+    void end() ;
+  };
+  
+  ManagerData::ManagerData()
+  {
+    this->threshold    = 0.0                                    ;
+    this->regressions  = false                                  ;
+    this->shard        = 0                                      ;
+    this->shards       = 0                                      ;
+    this->timeout      = 0.0                                    ;
+    this->deadline     = 0.0                                    ;
+    this->counters     = false                                  ;
+    this->budget       = { BUDGET_UNLIMITED, BUDGET_UNLIMITED } ;
+    this->fingerprint  = 0                                      ;
+    this->max_failures = 0                                      ;
+    this->failures     = 0                                      ;
+    this->repeat       = 0                                      ;
+    this->retries      = 0                                      ;
+    this->console      = nullptr                                ;
+    this->summary      = Summary()                              ;
+    this->cursor       = 0                                      ;
+    this->next         = 0                                      ;
+  }
+  
+  Record ManagerData::execute( const Test& test, unsigned item, bool counters )
+  {
+    Record    outcome ;
+    TimePoint begin   ;
+    TimePoint end     ;
+    double    time    ;
+    Result    result  ;
+    bool      tracked ;
+
+    tracked  = startAllocations() ;
+    counters = counters && startCounters() ;
+    begin    = std::chrono::steady_clock::now() ;
+    result   = test.callable->test( item ) ;
+    end      = std::chrono::steady_clock::now() ;
+    
+    if( result.value() == Result::Skip )
+    {
+      time = 0.0 ;
+    }
+    else
+    {
+      time = std::chrono::duration<double, std::micro>( end - begin ).count() ;
+    }
+    
+    outcome        = Record() ;
+    outcome.result = result   ;
+    outcome.time   = time     ;
+    
+    if( counters ) stopCounters   ( outcome.counters, 1 ) ;
+    if( tracked  ) stopAllocations( outcome.allocations ) ;
+    
+    return outcome ;
+  }
+
+  Record ManagerData::attempt( const Test& test, unsigned item, const Outcomes& outcomes, unsigned task )
+  {
+    const unsigned      repeat  = outcomes.repeat ;
+    std::vector<double> times   ;
+    Record              outcome ;
+    Record              run     ;
+    Repetition          runs    ;
+    double              total   ;
+    
+    if( repeat == 1 && outcomes.retries == 0 ) return ManagerData::execute( test, item, outcomes.counters ) ;
+    
+    runs  = Repetition() ;
+    total = 0.0          ;
+    while( runs.runs < repeat || ( runs.passed == 0 && runs.retries < outcomes.retries ) )
+    {
+      if( runs.runs != 0 && ( outcomes.stopping || outcomes.stored[ task ] > item ) ) break ;
+      if( runs.runs >= repeat ) runs.retries++ ;
+      
+      run = ManagerData::execute( test, item, outcomes.counters ) ;
+      
+      // A skipped test would skip every run again.
+      if( run.result.value() == Result::Skip ) return run ;
+      
+      runs.runs++ ;
+      total += run.time ;
+      times.push_back( run.time * 1000.0 ) ;
+      
+      if     ( run.result.value() == Result::Pass ) runs.passed++            ;
+      else if( runs.first == 0                    ) runs.first = runs.runs ;
+      
+      // The first failure is what the test reports, since it's what a rerun would need to reproduce.
+      if( runs.first == 0 || runs.first == runs.runs ) outcome = run ;
+    }
+    
+    if( runs.passed != 0 && runs.passed != runs.runs ) outcome.result.set( Result::Flaky ) ;
+    
+    runs.times         = summarize( times.data(), times.size(), 1 ) ;
+    outcome.time       = total ;
+    outcome.repetition = runs  ;
+    
+    return outcome ;
+  }
+
+  Record ManagerData::benchmark( unsigned task ) const
+  {
+    Callable* callback = ( *this->tests )[ task ].callable ;
+    Record    outcome  ;
+    TimePoint begin    ;
+    
+    auto sweep = this->sweeps.empty() ? this->sweeps.end() : this->sweeps.find( this->registry.name( ( *this->tests )[ task ].index ) ) ;
+    if( sweep != this->sweeps.end() ) return this->sweep( task, sweep->second ) ;
+    
+    auto contender = this->contenders.empty() ? this->contenders.end() : this->contenders.find( this->registry.name( ( *this->tests )[ task ].index ) ) ;
+    if( contender != this->contenders.end() ) return this->contend( task, contender->second ) ;
+    
+    outcome            = Record() ;
+    begin              = std::chrono::steady_clock::now() ;
+    outcome.statistics = measure( [callback]( std::uint64_t iterations ) { callback->run( iterations ) ; }, emptyLoop() ) ;
+    outcome.time       = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - begin ).count() ;
+    outcome.result     = Result( Result::Pass ) ;
+    
+    this->profile( task, outcome ) ;
+    
+    return outcome ;
+  }
+
+  Record ManagerData::sweep( unsigned task, const Sweep& sweep ) const
+  {
+    const SizedLoop&        loop        = sweep.loop ;
+    std::vector<double>     sizes       ;
+    std::vector<double>     times       ;
+    std::vector<Loop>       loops       ;
+    std::vector<Statistics> statistics  ;
+    std::vector<Comparison> comparisons ;
+    Record                  outcome     ;
+    TimePoint               begin       ;
+    
+    outcome = Record() ;
+    begin   = std::chrono::steady_clock::now() ;
+    
+    // The largest size is always measured, even when doubling skips past it.
+    for( std::uint64_t size = std::max<std::uint64_t>( sweep.min, 1 ); sizes.empty() || sizes.back() < sweep.max; size = size > sweep.max / 2 ? sweep.max : size * 2 )
+    {
+      sizes.push_back( static_cast<double>( size ) ) ;
+      loops.push_back( [&loop, size]( std::uint64_t iterations ) { loop( size, iterations ) ; } ) ;
+    }
+    
+    // The sizes are sampled in interleaved rounds, like variants, so a slow spell of the machine can't bend the curve by
+    // landing on only some of them. The fastest sample of every size is fitted, being the one least disturbed.
+    statistics .resize( loops.size() ) ;
+    comparisons.resize( loops.size() ) ;
+    athena::compare( loops.data(), loops.size(), emptyLoop(), statistics.data(), comparisons.data() ) ;
+    
+    for( const Statistics& measured : statistics ) times.push_back( measured.min ) ;
+    
+    outcome.statistics = statistics.back() ;
+    outcome.scaling = fit( sizes.data(), times.data(), sizes.size() ) ;
+    outcome.time    = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - begin ).count() ;
+    outcome.result  = Result( Result::Pass ) ;
+    
+    this->profile( task, outcome ) ;
+    
+    return outcome ;
+  }
+
+  Record ManagerData::contend( unsigned task, const Contender& contender ) const
+  {
+    const unsigned threads = contender.threads != 0 ? contender.threads : std::max( std::thread::hardware_concurrency(), 1u ) ;
+    Record         outcome ;
+    TimePoint      begin   ;
+    
+    outcome            = Record() ;
+    begin              = std::chrono::steady_clock::now() ;
+    outcome.contention = athena::contend( contender.loop, threads, emptyLoop() ) ;
+    outcome.statistics = outcome.contention.front().statistics ;
+    outcome.time       = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - begin ).count() ;
+    outcome.result     = Result( Result::Pass ) ;
+    
+    this->profile( task, outcome ) ;
+    
+    return outcome ;
+  }
+
+  void ManagerData::profile( unsigned task, Record& outcome ) const
+  {
+    Callable*   callback = ( *this->tests )[ task ].callable ;
+    const char* name     = this->registry.name( ( *this->tests )[ task ].index ) ;
+    
+    // Counting one more sample keeps the counters' own overhead out of the measured samples.
+    if( this->counters && startCounters() )
+    {
+      callback->run( outcome.statistics.iterations ) ;
+      stopCounters( outcome.counters, outcome.statistics.iterations ) ;
+    }
+    
+    // Once warmed up, a single iteration shows what the benchmarked work allocates each time it runs.
+    if( startAllocations() )
+    {
+      callback->run( 1 ) ;
+      stopAllocations( outcome.allocations ) ;
+    }
+    
+    auto throughput = this->throughputs.empty() ? this->throughputs.end() : this->throughputs.find( name ) ;
+    if( throughput == this->throughputs.end() ) return ;
+    
+    // A sweep's amounts are per unit of size, and its statistics are those of its largest size.
+    auto sweep = this->sweeps.find( name ) ;
+    const std::uint64_t units = sweep != this->sweeps.end() ? sweep->second.max : 1 ;
+    
+    outcome.throughput.items = throughput->second.items * units ;
+    outcome.throughput.bytes = throughput->second.bytes * units ;
+  }
+
+  std::vector<unsigned> ManagerData::siblings( unsigned task, const std::vector<unsigned>& measured ) const
+  {
+    const TestList&       tests = *this->tests ;
+    std::vector<unsigned> found ;
+    
+    auto group = this->groups.empty() ? this->groups.end() : this->groups.find( this->registry.name( tests[ task ].index ) ) ;
+    if( group == this->groups.end() ) return { task } ;
+    
+    for( const auto& name : this->variants.at( group->second ) )
+    {
+      const unsigned index = this->registry.find( name.c_str() ) ;
+      
+      for( unsigned other : measured )
+      {
+        if( tests[ other ].index == index ) found.push_back( other ) ;
+      }
+    }
+    
+    return found ;
+  }
+
+  void ManagerData::contrast( const std::vector<unsigned>& tasks, Outcomes& outcomes )
+  {
+    std::vector<Loop>       loops       ;
+    std::vector<Statistics> statistics  ;
+    std::vector<Comparison> comparisons ;
+    TimePoint               begin       ;
+    Record                  record      ;
+    double                  time        ;
+    
+    for( unsigned task : tasks )
+    {
+      Callable* callback = ( *this->tests )[ task ].callable ;
+      
+      this->started( task, 0 ) ;
+      loops.push_back( [callback]( std::uint64_t iterations ) { callback->run( iterations ) ; } ) ;
+    }
+    
+    statistics .resize( tasks.size() ) ;
+    comparisons.resize( tasks.size() ) ;
+    
+    begin = std::chrono::steady_clock::now() ;
+    athena::compare( loops.data(), loops.size(), emptyLoop(), statistics.data(), comparisons.data() ) ;
+    time  = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - begin ).count() ;
+    
+    // The variants share the time they were measured together for.
+    for( unsigned variant = 0; variant < tasks.size(); variant++ )
+    {
+      record            = Record()               ;
+      record.result     = Result( Result::Pass ) ;
+      record.time       = time / tasks.size()    ;
+      record.statistics = statistics [ variant ] ;
+      record.comparison = comparisons[ variant ] ;
+      
+      this->profile( tasks[ variant ], record ) ;
+      this->complete( outcomes, tasks[ variant ], record ) ;
+    }
+  }
+
+  void ManagerData::dispatch( std::shared_ptr<const TestList> tests, const std::vector<double>& limits, const std::vector<unsigned>& tasks, std::shared_ptr<Outcomes> outcomes, unsigned jobs, TimePoint end )
+  {
+    Pool      pool      ;
+    Pool::Job job       ;
+    TimePoint now       ;
+    double    remaining ;
+    
+    now = std::chrono::steady_clock::now() ;
+    if( now >= end )
+    {
+      for( unsigned task : tasks ) this->complete( *outcomes, task, timedOut( 0.0, true ) ) ;
+      return ;
+    }
+    
+    pool.initialize( jobs ) ;
+    for( unsigned task : tasks ) pool.push( task ) ;
+    
+    // The job owns copies of everything it touches, since a timed out test keeps running after this returns. The test
+    // itself only reads the shared outcomes. The job only calls back into this object under the outcomes' lock, after
+    // checking its case is still its own, and the watchdog claims a batch under that lock too, so an abandoned job never
+    // reaches this object.
+    job = [this, tests, outcomes]( unsigned task, unsigned )
+    {
+      const Test&    test = ( *tests )[ task ]      ;
+      const unsigned last = test.first + test.count ;
+      Record         record ;
+      
+      for( unsigned item = test.first; item < last; item++ )
+      {
+        {
+          std::lock_guard<std::mutex> guard( outcomes->lock ) ;
+          
+          // Once the watchdog gives up on a batch, the rest of it is already reported and must not start.
+          if( outcomes->stored[ task ] != item ) return ;
+          
+          if( outcomes->stopping )
+          {
+            outcomes->store( task, item ) ;
+            this->finished( *outcomes, task, item, notRun() ) ;
+            continue ;
+          }
+          
+          this->started( task, item ) ;
+        }
+        
+        {
+          Token token( &outcomes->stopping, &outcomes->stored[ task ], item ) ;
+          
+          record = ManagerData::attempt( test, item, *outcomes, task ) ;
+        }
+        
+        std::lock_guard<std::mutex> guard( outcomes->lock ) ;
+        
+        if( !outcomes->store( task, item ) ) return ;
+        this->finished( *outcomes, task, item, record ) ;
+      }
+    } ;
+    
+    if( this->timeout <= 0.0 && this->timeouts.empty() && this->deadline <= 0.0 )
+    {
+      pool.run( job ) ;
+      return ;
+    }
+    
+    remaining = end == TimePoint::max() ? 0.0 : std::chrono::duration<double, std::milli>( end - now ).count() ;
+    
+    pool.run( job, 
+      [&limits, tests]( unsigned task ) 
+      { 
+        return limits[ task ] * ( *tests )[ task ].count ; 
+      },
+      [this, &limits, tests, outcomes]( unsigned task, double elapsed )
+      {
+        const double limit = limits[ task ] * ( *tests )[ task ].count ;
+        
+        // Every case of the batch that hasn't finished yet shares the fate of the one that hung.
+        return this->complete( *outcomes, task, timedOut( elapsed * 1000.0, limit <= 0.0 || elapsed < limit ) ) ;
+      }, 
+      remaining ) ;
+  }
+
+  void ManagerData::await( const TestList& tests, const std::vector<double>& limits, const std::vector<unsigned>& tasks, Outcomes& outcomes, unsigned jobs, TimePoint end )
+  {
+    Executor  executor ;
+    TimePoint now      ;
+    
+    if( tasks.empty() ) return ;
+    
+    now = std::chrono::steady_clock::now() ;
+    if( now >= end )
+    {
+      for( unsigned task : tasks ) this->complete( outcomes, task, timedOut( 0.0, true ) ) ;
+      return ;
+    }
+    
+    executor.initialize( jobs ) ;
+    for( unsigned task : tasks ) executor.push( task ) ;
+    
+    executor.run( 
+      [this, &tests, &outcomes]( unsigned task, Coroutine& coroutine )
+      {
+        if( outcomes.stopping )
+        {
+          this->complete( outcomes, task, notRun() ) ;
+          return false ;
+        }
+        
+        this->started( task, tests[ task ].first ) ;
+        return tests[ task ].callable->start( tests[ task ].first, coroutine ) ;
+      },
+      [&outcomes]( unsigned, const Coroutine& coroutine )
+      {
+        Token token( &outcomes.stopping, nullptr, 0 ) ;
+        
+        coroutine.resume( coroutine.frame ) ;
+      },
+      [this, &outcomes]( unsigned task, const Record& record )
+      {
+        this->complete( outcomes, task, record ) ;
+      },
+      [&limits]( unsigned task )
+      {
+        return limits[ task ] ;
+      },
+      end == TimePoint::max() ? 0.0 : std::max( std::chrono::duration<double, std::milli>( end - now ).count(), 1e-3 ) ) ;
+  }
+
+  void ManagerData::spawn( const TestList& tests, const std::vector<double>& limits, const std::vector<unsigned>& tasks, Outcomes& outcomes, unsigned jobs, TimePoint end )
+  {
+#ifdef __unix__
+    std::vector<Child>  children ;
+    std::vector<pollfd> fds      ;
+    Child               child    ;
+    TimePoint           now      ;
+    Record              record   ;
+    double              elapsed  ;
+    double              wait     ;
+    unsigned            next     ;
+    
+    if( jobs == 0 ) jobs = std::thread::hardware_concurrency() ;
+    if( jobs == 0 ) jobs = 1                                   ;
+    
+    // Anything still buffered would otherwise be printed again by every child.
+    std::cout.flush() ;
+    fflush( stdout ) ;
+    
+    next = 0 ;
+    while( next < tasks.size() || !children.empty() )
+    {
+      if( std::chrono::steady_clock::now() >= end )
+      {
+        for( const auto& running : children )
+        {
+          kill( running.pid, SIGKILL ) ;
+          record = this->reap( running ) ;
+          this->complete( outcomes, running.task, record.result.value() == Result::Crash ? timedOut( record.time, true ) : record ) ;
+        }
+        
+        for( ; next < tasks.size(); next++ ) this->complete( outcomes, tasks[ next ], timedOut( 0.0, true ) ) ;
+        
+        children.clear() ;
+        break ;
+      }
+      
+      while( next < tasks.size() && children.size() < jobs )
+      {
+        child.task = tasks[ next++ ] ;
+        if( outcomes.stopping )
+        {
+          this->complete( outcomes, child.task, notRun() ) ;
+          continue ;
+        }
+        
+        this->started( child.task, tests[ child.task ].first ) ;
+        if( this->launch( tests[ child.task ], outcomes, child ) ) children.push_back( child )                                                                                            ;
+        else                                                       this->complete( outcomes, child.task, ManagerData::attempt( tests[ child.task ], tests[ child.task ].first, outcomes, child.task ) ) ;
+      }
+      
+      // Sleep until a child finishes, or the closest timeout or the deadline passes.
+      now  = std::chrono::steady_clock::now() ;
+      wait = end == TimePoint::max() ? -1.0 : std::chrono::duration<double, std::milli>( end - now ).count() ;
+      fds.clear() ;
+      for( const auto& running : children )
+      {
+        fds.push_back( { running.fd, POLLIN, 0 } ) ;
+        
+        if( limits[ running.task ] > 0.0 )
+        {
+          elapsed = std::chrono::duration<double, std::milli>( now - running.begin ).count() ;
+          wait    = wait < 0.0 ? limits[ running.task ] - elapsed : std::min( wait, limits[ running.task ] - elapsed ) ;
+        }
+      }
+      
+      // A child's pipe becomes readable once it sends its result, or hangs up once it dies.
+      if( poll( fds.data(), fds.size(), wait < 0.0 ? -1 : static_cast<int>( std::ceil( std::max( wait, 0.0 ) ) ) ) < 0 ) continue ;
+      
+      now = std::chrono::steady_clock::now() ;
+      for( unsigned index = fds.size(); index > 0; index-- )
+      {
+        const Child& running = children[ index - 1 ] ;
+        
+        elapsed = std::chrono::duration<double, std::milli>( now - running.begin ).count() ;
+        if( fds[ index - 1 ].revents != 0 )
+        {
+          this->complete( outcomes, running.task, this->reap( running ) ) ;
+        }
+        else if( limits[ running.task ] > 0.0 && elapsed >= limits[ running.task ] )
+        {
+          kill( running.pid, SIGKILL ) ;
+          record = this->reap( running ) ;
+          this->complete( outcomes, running.task, record.result.value() == Result::Crash ? timedOut( record.time, false ) : record ) ;
+        }
+        else
+        {
+          continue ;
+        }
+        
+        children.erase( children.begin() + ( index - 1 ) ) ;
+      }
+    }
+#else
+    static_cast<void>( jobs   ) ;
+    static_cast<void>( limits ) ;
+    static_cast<void>( end    ) ;
+    for( unsigned task : tasks )
+    {
+      if( outcomes.stopping )
+      {
+        this->complete( outcomes, task, notRun() ) ;
+        continue ;
+      }
+      
+      Token token( &outcomes.stopping, &outcomes.stored[ task ], tests[ task ].first ) ;
+      
+      this->started( task, tests[ task ].first ) ;
+      this->complete( outcomes, task, ManagerData::attempt( tests[ task ], tests[ task ].first, outcomes, task ) ) ;
+    }
+#endif
+  }
+
+#ifdef __unix__
+  bool ManagerData::launch( const Test& test, const Outcomes& outcomes, Child& child ) const
+  {
+    Record     outcome ;
+    Message    message ;
+    int        fds[ 2 ] ;
+    
+    if( pipe( fds ) != 0 ) return false ;
+    
+    child.begin = std::chrono::steady_clock::now() ;
+    child.pid   = fork() ;
+    
+    if( child.pid < 0 )
+    {
+      close( fds[ 0 ] ) ;
+      close( fds[ 1 ] ) ;
+      return false ;
+    }
+    
+    if( child.pid == 0 )
+    {
+      close( fds[ 0 ] ) ;
+      outcome = ManagerData::attempt( test, test.first, outcomes, child.task ) ;
+      
+      message.result   = outcome.result.value() ;
+      message.time     = outcome.time           ;
+      message.counters    = outcome.counters       ;
+      message.allocations = outcome.allocations    ;
+      message.repetition  = outcome.repetition     ;
+      
+      std::cout.flush() ;
+      fflush( stdout ) ;
+      if( write( fds[ 1 ], &message, sizeof( Message ) ) != sizeof( Message ) ) _exit( 1 ) ;
+      _exit( 0 ) ;
+    }
+    
+    close( fds[ 1 ] ) ;
+    child.fd = fds[ 0 ] ;
+    
+    return true ;
+  }
+  
+  Record ManagerData::reap( const Child& child ) const
+  {
+    Record     outcome ;
+    Message    message ;
+    ssize_t    amount  ;
+    int        status  ;
+    
+    do { amount = read( child.fd, &message, sizeof( Message ) ) ; } while( amount < 0 && errno == EINTR ) ;
+    close( child.fd ) ;
+    
+    outcome = Record() ;
+    status  = 0        ;
+    while( waitpid( child.pid, &status, 0 ) < 0 && errno == EINTR ) {}
+    
+    if( amount == sizeof( Message ) && WIFEXITED( status ) && WEXITSTATUS( status ) == 0 )
+    {
+      outcome.result   = message.result   ;
+      outcome.time     = message.time     ;
+      outcome.counters    = message.counters    ;
+      outcome.allocations = message.allocations ;
+      outcome.repetition  = message.repetition  ;
+      
+      return outcome ;
+    }
+    
+    outcome.result.set( Result::Crash ) ;
+    outcome.time   = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - child.begin ).count() ;
+    
+    if( WIFSIGNALED( status ) )
+    {
+      outcome.reason = Reason::Signal       ;
+      outcome.code   = WTERMSIG( status )   ;
+    }
+    else
+    {
+      outcome.reason = Reason::Exit         ;
+      outcome.code   = WEXITSTATUS( status ) ;
+    }
+    
+    return outcome ;
+  }
+#endif
+
+  void ManagerData::run( unsigned jobs )
+  {
+    std::shared_ptr<Outcomes> outcomes ;
+    std::shared_ptr<TestList> tests    ;
+    std::vector<double>       limits   ;
+    std::vector<unsigned>     parallel ;
+    std::vector<unsigned>     isolated ;
+    std::vector<unsigned>     measured ;
+    std::vector<unsigned>     waiting  ;
+    std::vector<unsigned>     queued   ;
+    TimePoint                 end      ;
+    TimePoint                 start    ;
+    unsigned                  workers  ;
+    unsigned                  task     ;
+    unsigned                  count    ;
+    
+    this->select() ;
+    this->recall() ;
+    
+    this->failures = 0     ;
+    count          = 0     ;
+    tests          = std::make_shared<TestList>() ;
+    end   = TimePoint::max() ;
+    
+    if( this->deadline > 0.0 )
+    {
+      end = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double, std::milli>( this->deadline ) ) ;
+    }
+    
+    tests->reserve( this->selection.size() ) ;
+    limits.reserve( this->selection.size() ) ;
+    
+    // Tests are indexed in name order. The cases of a parameterized test are split into batches that follow each other,
+    // and share the timeout, shard and scheduling of their test. Cases run in-process on the pool are batched, while a
+    // child process or coroutine runs a single case. A repeated test's timeout is stretched over the most runs it may take.
+    for( unsigned index : this->selection )
+    {
+      const char*    name    = this->registry.name( index )                  ;
+      const unsigned cases   = std::max( this->registry.cases( index ), 1u ) ;
+      auto           timeout = this->timeouts.empty() ? this->timeouts.end() : this->timeouts.find( name ) ;
+      const bool     skipped = this->shards > 1 && hashName( name ) % this->shards != this->shard ;
+      const bool     single  = this->isolation.value() == Isolation::Process || this->registry.callable( index )->asynchronous() ;
+      const unsigned size    = single ? 1 : CASE_BATCH ;
+      const unsigned runs    = this->registry.callable( index )->asynchronous() ? 1 : std::max( this->repeat, 1u ) + this->retries ;
+      auto           suite   = this->suites.empty() ? this->suites.end() : this->suites.find( name ) ;
+      
+      for( unsigned first = 0; first < cases; first += size )
+      {
+        task = tests->size() ;
+        
+        tests->push_back( { this->registry.callable( index ), index, first, std::min( size, cases - first ) } ) ;
+        limits.push_back( ( timeout != this->timeouts.end() ? timeout->second : this->timeout ) * runs ) ;
+        
+        if( skipped ) continue ;
+        
+        count += tests->back().count ;
+        if( suite != this->suites.end() ) suite->second->expect( tests->back().count ) ;
+        
+        if     ( this->registry.benchmark( index )                  ) measured.push_back( task ) ;
+        else if( this->registry.callable( index )->asynchronous()   ) waiting .push_back( task ) ;
+        else if( !this->serial.empty() && this->serial.count( name ) ) isolated.push_back( task ) ;
+        else                                                            parallel.push_back( task ) ;
+      }
+    }
+    
+    outcomes    = std::make_shared<Outcomes>( *tests, this->repeat, this->retries, this->counters ) ;
+    this->tests = tests                                                                   ;
+    
+    // Tests are reported in the order they are scheduled in, however their threads or children happen to finish.
+    this->order.clear() ;
+    this->order.insert( this->order.end(), parallel.begin(), parallel.end() ) ;
+    this->order.insert( this->order.end(), waiting .begin(), waiting .end() ) ;
+    this->order.insert( this->order.end(), isolated.begin(), isolated.end() ) ;
+    this->order.insert( this->order.end(), measured.begin(), measured.end() ) ;
+    this->rank.assign( tests->size(), 0 ) ;
+    for( unsigned position = 0; position < this->order.size(); position++ ) this->rank[ this->order[ position ] ] = position ;
+    this->pending.clear() ;
+    this->cursor = 0                                                            ;
+    this->next   = this->order.empty() ? 0 : ( *tests )[ this->order[ 0 ] ].first ;
+    
+    this->begin( count ) ;
+    
+    // Parallel tests start longest first, while still being reported in name order.
+    queued = parallel ;
+    this->schedule( *tests, queued ) ;
+    
+    workers = jobs != 0 ? jobs : std::max( std::thread::hardware_concurrency(), 1u ) ;
+    start   = std::chrono::steady_clock::now()                                        ;
+    
+    if( this->isolation.value() == Isolation::Process )
+    {
+      this->spawn( *tests, limits, queued, *outcomes, jobs, end ) ;
+      this->utilization( parallel, *outcomes, workers, std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count() ) ;
+      this->await( *tests, limits, waiting, *outcomes, jobs, end ) ;
+      this->spawn( *tests, limits, isolated, *outcomes, 1, end ) ;
+    }
+    else
+    {
+      this->dispatch( tests, limits, queued, outcomes, jobs, end ) ;
+      this->utilization( parallel, *outcomes, workers, std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count() ) ;
+      this->await( *tests, limits, waiting, *outcomes, jobs, end ) ;
+      this->dispatch( tests, limits, isolated, outcomes, 1, end ) ;
+    }
+    
+    // Benchmarks always run alone and in-process, so nothing else competes with them for the core. The variants of a
+    // benchmark are all measured together when the first of them comes up.
+    for( unsigned task : measured )
+    {
+      // A variant measured along with an earlier one is already reported.
+      if( outcomes->stored[ task ] != ( *tests )[ task ].first ) continue ;
+      
+      if( std::chrono::steady_clock::now() >= end )
+      {
+        this->complete( *outcomes, task, timedOut( 0.0, true ) ) ;
+      }
+      else if( outcomes->stopping )
+      {
+        this->complete( *outcomes, task, notRun() ) ;
+      }
+      else
+      {
+        Token token( &outcomes->stopping, nullptr, 0 ) ;
+        
+        if( this->siblings( task, measured ).size() > 1 )
+        {
+          this->contrast( this->siblings( task, measured ), *outcomes ) ;
+          continue ;
+        }
+        
+        this->started( task, 0 ) ;
+        this->complete( *outcomes, task, this->benchmark( task ) ) ;
+      }
+    }
+    
+    // Suites whose tests were cut off by the deadline never saw their last test, so they are torn down here instead.
+    for( auto& suite : this->suites ) suite.second->teardown() ;
+    
+    this->commit() ;
+    
+    this->end() ;
+  }
+
+  void ManagerData::enforce( const std::string& name, Record& record ) const
+  {
+    Budget budget ;
+    
+    if( record.result.value() != Result::Pass ) return ;
+    
+    // Only growing faster than expected fails, so a sweep that turns out better than expected still passes.
+    auto expected = this->complexities.empty() ? this->complexities.end() : this->complexities.find( name ) ;
+    if( expected != this->complexities.end() && record.scaling.sizes != 0 && record.scaling.complexity > expected->second.value() )
+    {
+      record.result = Result( Result::Fail ) ;
+      record.reason = Reason::Complexity     ;
+      return ;
+    }
+    
+    if( !record.allocations.tracked ) return ;
+    
+    auto found = this->budgets.empty() ? this->budgets.end() : this->budgets.find( name ) ;
+    budget     = found != this->budgets.end() ? found->second : this->budget ;
+    
+    if( record.allocations.count > budget.allocations || record.allocations.peak > budget.bytes )
+    {
+      record.result = Result( Result::Fail ) ;
+      record.reason = Reason::Budget         ;
+    }
+  }
+
+  void ManagerData::compare( const std::string& name, Record& record ) const
+  {
+    RecordMap::const_iterator previous ;
+    double                    current  ;
+    double                    before   ;
+    double                    noise    ;
+    
+    previous = this->baseline.find( name ) ;
+    
+    if( previous == this->baseline.end()                                                         ) return ;
+    if( record.result.value() != Result::Pass || previous->second.result.value() != Result::Pass ) return ;
+    
+    const Statistics& now  = record.statistics           ;
+    const Statistics& then = previous->second.statistics ;
+    
+    if( now.samples > 1 && then.samples > 1 )
+    {
+      current = now.median  ;
+      before  = then.median ;
+      noise   = NOISE_SIGMAS * std::sqrt( now.stddev * now.stddev / now.samples + then.stddev * then.stddev / then.samples ) ;
+    }
+    else
+    {
+      current = record.time           ;
+      before  = previous->second.time ;
+      noise   = TEST_NOISE            ;
+    }
+    
+    if( before <= 0.0 ) return ;
+    
+    record.compared   = true                                                       ;
+    record.delta      = ( current - before ) / before                              ;
+    record.regression = record.delta > this->threshold && current - before > noise ;
+    
+    if( record.regression && this->regressions )
+    {
+      record.result.set( Result::Fail ) ;
+      record.reason = Reason::Regression ;
+    }
+  }
+
+  bool ManagerData::filter( const char* list, bool exclude )
+  {
+    std::string entries ;
+    std::string entry   ;
+    Filter      filter  ;
+    size_t      offset  ;
+    size_t      next    ;
+    bool        valid   ;
+    
+    entries = list ;
+    offset  = 0    ;
+    valid   = true ;
+    
+    while( offset < entries.size() )
+    {
+      next   = std::min( entries.find( ',', offset ), entries.size() ) ;
+      entry  = entries.substr( offset, next - offset )                 ;
+      offset = next + 1                                                ;
+      
+      if( entry.empty() ) continue ;
+      
+      if( !makeFilter( entry.c_str(), filter ) ) valid = false                                                  ;
+      else                                       ( exclude ? this->excludes : this->includes ).push_back( filter ) ;
+    }
+    
+    return valid ;
+  }
+
+  bool ManagerData::matches( const Filter& filter, unsigned index ) const
+  {
+    const char* name = this->registry.name( index ) ;
+    
+    switch( filter.kind )
+    {
+      case Filter::Glob :
+        return matchGlob( filter.pattern.c_str(), name ) ;
+      case Filter::Regex :
+        return std::regex_match( name, filter.regex ) ;
+      case Filter::Tag :
+      {
+        auto tag = this->tags.find( filter.pattern ) ;
+        return tag != this->tags.end() && tag->second.count( name ) != 0 ;
+      }
+      default :
+        return false ;
+    };
+  }
+
+  void ManagerData::recall()
+  {
+    std::vector<unsigned>::iterator last ;
+    
+    if( this->history_path.empty() ) return ;
+    
+    this->latest.assign( this->registry.size(), { 0, UNSEEN, 0.0 } ) ;
+    if( this->history.empty() || this->rerun.value() == Rerun::All ) return ;
+    
+    // Looks up how a test did last time, as a failure, a pass in this same build, or anything else.
+    auto failed = [this]( unsigned index )
+    {
+      auto entry = this->history.find( this->registry.name( index ) ) ;
+      return entry != this->history.end() && isFailure( entry->second.result ) ;
+    } ;
+    
+    auto unchanged = [this]( unsigned index )
+    {
+      auto entry = this->history.find( this->registry.name( index ) ) ;
+      return entry != this->history.end() && entry->second.result == Result::Pass && this->fingerprint != 0 && entry->second.fingerprint == this->fingerprint ;
+    } ;
+    
+    switch( this->rerun.value() )
+    {
+      case Rerun::FailedFirst :
+        std::stable_partition( this->selection.begin(), this->selection.end(), failed ) ;
+        break ;
+      case Rerun::OnlyFailed :
+        last = std::stable_partition( this->selection.begin(), this->selection.end(), failed ) ;
+        if( last != this->selection.begin() ) this->selection.erase( last, this->selection.end() ) ;
+        break ;
+      case Rerun::SkipPassed :
+        this->selection.erase( std::remove_if( this->selection.begin(), this->selection.end(), unchanged ), this->selection.end() ) ;
+        break ;
+      default :
+        break ;
+    };
+  }
+
+  void ManagerData::schedule( const TestList& tests, std::vector<unsigned>& tasks ) const
+  {
+    std::vector<double> known    ;
+    std::vector<double> expected ;
+    double              fallback ;
+    
+    if( this->history.empty() || tasks.size() < 2 ) return ;
+    
+    // The time of a batch is its share of its test's time. Unknown tests are marked negative for now.
+    expected.assign( tests.size(), -1.0 ) ;
+    for( unsigned task : tasks )
+    {
+      const unsigned index = tests[ task ].index                                ;
+      auto           entry = this->history.find( this->registry.name( index ) ) ;
+      
+      if( entry == this->history.end() ) continue ;
+      
+      expected[ task ] = entry->second.time * tests[ task ].count / std::max( this->registry.cases( index ), 1u ) ;
+      if( tests[ task ].first == 0 ) known.push_back( entry->second.time ) ;
+    }
+    
+    if( known.empty() ) return ;
+    
+    std::nth_element( known.begin(), known.begin() + known.size() / 2, known.end() ) ;
+    fallback = known[ known.size() / 2 ] ;
+    
+    for( unsigned task : tasks )
+    {
+      const unsigned index = tests[ task ].index ;
+      
+      if( expected[ task ] < 0.0 ) expected[ task ] = fallback * tests[ task ].count / std::max( this->registry.cases( index ), 1u ) ;
+    }
+    
+    std::stable_sort( tasks.begin(), tasks.end(), [&expected]( unsigned first, unsigned second ) { return expected[ first ] > expected[ second ] ; } ) ;
+  }
+
+  void ManagerData::utilization( const std::vector<unsigned>& tasks, const Outcomes& outcomes, unsigned workers, double makespan )
+  {
+    double total   ;
+    double longest ;
+    
+    if( tasks.empty() ) return ;
+    
+    total   = 0.0 ;
+    longest = 0.0 ;
+    
+    std::lock_guard<std::mutex> guard( this->lock ) ;
+    
+    // Every batch runs on a single worker, so the longest one bounds the makespan.
+    for( unsigned task : tasks )
+    {
+      total  += outcomes.times[ task ]                     ;
+      longest = std::max( longest, outcomes.times[ task ] ) ;
+    }
+    
+    
+    this->summary.makespan = makespan                             ;
+    this->summary.ideal    = std::max( total / workers, longest ) ;
+  }
+
+  void ManagerData::tally( Outcomes& outcomes )
+  {
+    this->failures++ ;
+    if( this->max_failures != 0 && this->failures >= this->max_failures ) outcomes.stopping = true ;
+  }
+
+  void ManagerData::remember( unsigned task, const Record& record )
+  {
+    // A test that never ran keeps what the history knew of it.
+    if( this->history_path.empty() || record.result.value() == Result::NotRun ) return ;
+    
+    History& entry = this->latest[ ( *this->tests )[ task ].index ] ;
+    
+    // A parameterized test keeps its worst case, so one failing case is enough to rerun it.
+    if( entry.result == UNSEEN || ( isFailure( record.result.value() ) && !isFailure( entry.result ) ) ) entry.result = record.result.value() ;
+    entry.time += record.time ;
+  }
+
+  void ManagerData::commit()
+  {
+    if( this->history_path.empty() ) return ;
+    
+    for( unsigned index = 0; index < this->latest.size(); index++ )
+    {
+      if( this->latest[ index ].result == UNSEEN ) continue ;
+      
+      this->latest[ index ].fingerprint                = this->fingerprint    ;
+      this->history[ this->registry.name( index ) ] = this->latest[ index ] ;
+    }
+    
+    if( !saveHistory( this->history_path.c_str(), this->history ) )
+    {
+      std::cerr << "athena: Unable to save the history to " << this->history_path << "\n" ;
+    }
+  }
+
+  void ManagerData::select()
+  {
+    unsigned first ;
+    unsigned last  ;
+    unsigned index ;
+    
+    this->selection.clear() ;
+    
+    if( this->includes.empty() )
+    {
+      this->selection.resize( this->registry.size() ) ;
+      for( index = 0; index < this->selection.size(); index++ ) this->selection[ index ] = index ;
+    }
+    
+    for( const auto& filter : this->includes )
+    {
+      if( filter.kind == Filter::Tag )
+      {
+        auto tag = this->tags.find( filter.pattern ) ;
+        if( tag == this->tags.end() ) continue ;
+        
+        for( const auto& name : tag->second )
+        {
+          index = this->registry.find( name.c_str() ) ;
+          if( index < this->registry.size() ) this->selection.push_back( index ) ;
+        }
+        continue ;
+      }
+      
+      this->registry.range( filter.prefix.c_str(), first, last ) ;
+      for( index = first; index < last; index++ )
+      {
+        if( this->matches( filter, index ) ) this->selection.push_back( index ) ;
+      }
+    }
+    
+    if( this->includes.size() > 1 || ( !this->includes.empty() && this->includes[ 0 ].kind == Filter::Tag ) )
+    {
+      std::sort( this->selection.begin(), this->selection.end() ) ;
+      this->selection.erase( std::unique( this->selection.begin(), this->selection.end() ), this->selection.end() ) ;
+    }
+    
+    if( this->excludes.empty() ) return ;
+    
+    this->selection.erase( std::remove_if( this->selection.begin(), this->selection.end(), [this]( unsigned test )
+    {
+      for( const auto& filter : this->excludes ) if( this->matches( filter, test ) ) return true ;
+      return false ;
+    } ), this->selection.end() ) ;
+  }
+
+  bool ManagerData::format( const char* list )
+  {
+    FormatList  formats ;
+    Console*    console ;
+    std::string entry   ;
+    std::string name    ;
+    std::string path    ;
+    size_t      split   ;
+    size_t      offset  ;
+    size_t      next    ;
+    bool        opened  ;
+    
+    console = nullptr ;
+    offset  = 0       ;
+    entry   = list    ;
+    
+    while( offset <= entry.size() )
+    {
+      next  = entry.find( ',', offset ) ;
+      if( next == std::string::npos ) next = entry.size() ;
+      
+      name   = entry.substr( offset, next - offset ) ;
+      offset = next + 1                              ;
+      split  = name.find( '=' )                      ;
+      path   = split == std::string::npos ? std::string() : name.substr( split + 1 ) ;
+      name   = name.substr( 0, split )               ;
+      
+      if( name.empty() ) continue ;
+      
+      if( name == "console" )
+      {
+        console = new Console() ;
+        formats.emplace_back( console ) ;
+        opened = console->initialize( path.empty() ? nullptr : path.c_str() ) ;
+      }
+      else if( name == "junit" )
+      {
+        JUnit* junit = new JUnit() ;
+        formats.emplace_back( junit ) ;
+        opened = junit->initialize( path.empty() ? nullptr : path.c_str() ) ;
+      }
+      else if( name == "jsonl" )
+      {
+        JsonLines* json = new JsonLines() ;
+        formats.emplace_back( json ) ;
+        opened = json->initialize( path.empty() ? nullptr : path.c_str() ) ;
+      }
+      else
+      {
+        return false ;
+      }
+      
+      if( !opened ) return false ;
+    }
+    
+    this->formats = std::move( formats ) ;
+    this->console = console              ;
+    
+    return true ;
+  }
+
+  void ManagerData::begin( unsigned count )
+  {
+    this->saved.clear() ;
+    this->summary          = Summary()                ;
+    this->summary.compared = !this->baseline.empty() ;
+    
+    this->active.clear() ;
+    for( const auto& format : this->formats ) this->active.push_back( format.get() ) ;
+    this->active.insert( this->active.end(), this->reporters.begin(), this->reporters.end() ) ;
+    
+    for( auto reporter : this->active ) reporter->begin( this->program_name.c_str(), count ) ;
+    
+    if( !this->journal_path.empty() && !this->journal.open( this->journal_path.c_str(), count ) )
+    {
+      std::cerr << "athena: Unable to open the journal " << this->journal_path << "\n" ;
+    }
+  }
+
+  std::string ManagerData::label( unsigned task, unsigned item ) const
+  {
+    const Test& test = ( *this->tests )[ task ] ;
+    std::string name ;
+    
+    name = this->registry.name( test.index ) ;
+    if( this->registry.cases( test.index ) == 0 ) return name ;
+    
+    name += '[' ;
+    name += std::to_string( item ) ;
+    name += ']' ;
+    
+    return name ;
+  }
+
+  void ManagerData::started( unsigned task, unsigned item )
+  {
+    std::lock_guard<std::mutex> guard( this->lock ) ;
+    
+    const std::string name = this->label( task, item ) ;
+    
+    for( auto reporter : this->active ) reporter->start( name.c_str() ) ;
+  }
+
+  void ManagerData::finished( Outcomes& outcomes, unsigned task, unsigned item, Record record )
+  {
+    std::lock_guard<std::mutex> guard( this->lock ) ;
+    
+    const TestList& tests = *this->tests ;
+    bool            failed ;
+    
+    outcomes.times[ task ] += record.time ;
+    
+    // Stopping early doesn't wait for the failure's turn to be reported.
+    if( isFailure( record.result.value() ) ) this->tally( outcomes ) ;
+    
+    // Only records finishing ahead of their turn are held, so the next case in order is reported without being copied.
+    if( this->rank[ task ] != this->cursor || item != this->next )
+    {
+      this->pending.emplace( Turn( this->rank[ task ], item ), std::move( record ) ) ;
+      return ;
+    }
+    
+    while( true )
+    {
+      const std::string name = this->label( task, item ) ;
+      
+      failed = isFailure( record.result.value() ) ;
+      
+      this->enforce ( name, record ) ;
+      this->compare ( name, record ) ;
+      this->remember( task, record ) ;
+      this->report  ( name, record ) ;
+      
+      // A test failed only by its budget or a regression is counted once its record is final.
+      if( isFailure( record.result.value() ) && !failed ) this->tally( outcomes ) ;
+      
+      if( ++this->next == tests[ task ].first + tests[ task ].count && ++this->cursor < this->order.size() )
+      {
+        this->next = tests[ this->order[ this->cursor ] ].first ;
+      }
+      
+      auto held = this->pending.begin() ;
+      if( held == this->pending.end() || held->first != Turn( this->cursor, this->next ) ) return ;
+      
+      task   = this->order[ this->cursor ] ;
+      item   = this->next                  ;
+      record = std::move( held->second )   ;
+      this->pending.erase( held ) ;
+    }
+  }
+
+  bool ManagerData::complete( Outcomes& outcomes, unsigned task, const Record& record )
+  {
+    const unsigned last = ( *this->tests )[ task ].first + ( *this->tests )[ task ].count ;
+    unsigned       item ;
+    
+    std::lock_guard<std::mutex> guard( outcomes.lock ) ;
+    
+    item = outcomes.stored[ task ].exchange( last ) ;
+    if( item == last ) return false ;
+    
+    for( ; item < last; item++ ) this->finished( outcomes, task, item, record ) ;
+    return true ;
+  }
+
+  void ManagerData::report( const std::string& name, const Record& record )
+  {
+    formatRecord( this->saved, name, record ) ;
+    this->journal.append( name, record ) ;
+    this->summary.time += record.time ;
+    if( record.regression ) this->summary.regressed++ ;
+    
+    switch( record.result.value() )
+    {
+      case Result::Fail    :
+      case Result::Crash   :
+      case Result::Timeout :
+        this->summary.failed++  ;
+        break ;
+      case Result::Pass :
+        this->summary.passed++  ;
+        break ;
+      case Result::Skip :
+        this->summary.skipped++ ;
+        break ;
+      case Result::NotRun :
+        this->summary.notrun++  ;
+        break ;
+      case Result::Flaky :
+        this->summary.flaky++   ;
+        break ;
+      default :
+        break ;
+    };
+    
+    for( auto reporter : this->active ) reporter->finish( name.c_str(), record ) ;
+  }
+
+  void ManagerData::end()
+  {
+    for( auto reporter : this->active ) reporter->end( this->summary ) ;
+    
+    this->journal.close() ;
+  }
+
+  Result::Result()
+  {
+    this->enumeration = Result::Skip ;
+  }
+
+  Result::Result( const Result& result )
+  {
+    this->enumeration = result.enumeration ;
+  }
+
+  Result::Result( unsigned result )
+  {
+    this->enumeration = result ;
+  }
+
+  Result& Result::operator=( const Result& result )
+  {
+    this->enumeration = result.enumeration ;
+    
+    return *this ;
+  }
+
+  Result& Result::operator=( unsigned result )
+  {
+    this->enumeration = result ;
+    
+    return *this ;
+  }
+
+  Result& Result::operator=( bool result )
+  {
+    this->enumeration = result ;
+    
+    return *this ;
+  }
+
+  const char* Result::name() const
+  {
+    return nameFromResult( *this ) ;
+  }
+
+  const char* Result::symbol() const
+  {
+    return symbolFromResult( *this ) ;
+  }
+
+  void Result::set( unsigned result )
+  {
+    this->enumeration = result ;
+  }
+
+  Result::operator unsigned() const
+  {
+    return this->enumeration ;
+  }
+
+  Result::operator bool() const
+  {
+    return static_cast<bool>( this->enumeration == 1 ? true : false ) ;
+  }
+
+  unsigned Result::value() const
+  {
+    return this->enumeration ;
+  }
+  
+  Output::Output()
+  {
+    this->enumeration = Output::Normal ;
+  }
+
+  Output::Output( unsigned output_type )
+  {
+    this->enumeration = output_type ;
+  }
+
+  Output::operator unsigned() const
+  {
+    return this->enumeration ;
+  }
+
+  Output& Output::operator=( unsigned output_type )
+  {
+    this->enumeration = output_type ;
+    
+    return *this ;
+  }
+
+  const char* Output::name() const
+  {
+    return nameFromOutput( *this ) ;
+  }
+
+  void Output::set( unsigned output_type )
+  {
+    this->enumeration = output_type ;
+  }
+
+  unsigned Output::value() const
+  {
+    return this->enumeration ;
+  }
+  
+  Reason::Reason()
+  {
+    this->enumeration = Reason::None ;
+  }
+
+  Reason::Reason( unsigned reason )
+  {
+    this->enumeration = reason ;
+  }
+
+  Reason::operator unsigned() const
+  {
+    return this->enumeration ;
+  }
+
+  Reason& Reason::operator=( unsigned reason )
+  {
+    this->enumeration = reason ;
+    
+    return *this ;
+  }
+
+  const char* Reason::name() const
+  {
+    return nameFromReason( *this ) ;
+  }
+
+  void Reason::set( unsigned reason )
+  {
+    this->enumeration = reason ;
+  }
+
+  unsigned Reason::value() const
+  {
+    return this->enumeration ;
+  }
+  
+  Rerun::Rerun()
+  {
+    this->enumeration = Rerun::All ;
+  }
+
+  Rerun::Rerun( unsigned rerun )
+  {
+    this->enumeration = rerun ;
+  }
+
+  Rerun::operator unsigned() const
+  {
+    return this->enumeration ;
+  }
+
+  Rerun& Rerun::operator=( unsigned rerun )
+  {
+    this->enumeration = rerun ;
+    
+    return *this ;
+  }
+
+  const char* Rerun::name() const
+  {
+    return nameFromRerun( *this ) ;
+  }
+
+  void Rerun::set( unsigned rerun )
+  {
+    this->enumeration = rerun ;
+  }
+
+  unsigned Rerun::value() const
+  {
+    return this->enumeration ;
+  }
+
+  Isolation::Isolation()
+  {
+    this->enumeration = Isolation::None ;
+  }
+
+  Isolation::Isolation( unsigned isolation )
+  {
+    this->enumeration = isolation ;
+  }
+
+  Isolation::operator unsigned() const
+  {
+    return this->enumeration ;
+  }
+
+  Isolation& Isolation::operator=( unsigned isolation )
+  {
+    this->enumeration = isolation ;
+    
+    return *this ;
+  }
+
+  const char* Isolation::name() const
+  {
+    return nameFromIsolation( *this ) ;
+  }
+
+  void Isolation::set( unsigned isolation )
+  {
+    this->enumeration = isolation ;
+  }
+
+  unsigned Isolation::value() const
+  {
+    return this->enumeration ;
+  }
+  
+  Complexity::Complexity()
+  {
+    this->enumeration = Complexity::None ;
+  }
+
+  Complexity::Complexity( unsigned complexity )
+  {
+    this->enumeration = complexity ;
+  }
+
+  Complexity::operator unsigned() const
+  {
+    return this->enumeration ;
+  }
+
+  Complexity& Complexity::operator=( unsigned complexity )
+  {
+    this->enumeration = complexity ;
+    
+    return *this ;
+  }
+
+  const char* Complexity::name() const
+  {
+    return nameFromComplexity( *this ) ;
+  }
+
+  void Complexity::set( unsigned complexity )
+  {
+    this->enumeration = complexity ;
+  }
+
+  unsigned Complexity::value() const
+  {
+    return this->enumeration ;
+  }
+  
+  void Manager::construct()
+  {
+    const char* formats = getenv( "ATHENA_FORMAT" ) ;
+    
+    this->manager_data = new ManagerData() ;
+    
+    if( formats != nullptr && !data().format( formats ) )
+    {
+      std::cerr << "athena: Unable to report in ATHENA_FORMAT " << formats << ", using the console.\n" ;
+      formats = nullptr ;
+    }
+    
+    if( formats == nullptr ) data().format( "console" ) ;
+    
+    if( getenv( "ATHENA_COUNTERS"  ) != nullptr ) data().counters  = strcmp( getenv( "ATHENA_COUNTERS"  ), "0" ) != 0 ;
+    if( getenv( "ATHENA_FAIL_FAST"    ) != nullptr ) data().max_failures = strcmp( getenv( "ATHENA_FAIL_FAST" ), "0" ) != 0          ;
+    if( getenv( "ATHENA_MAX_FAILURES" ) != nullptr ) data().max_failures = strtoul( getenv( "ATHENA_MAX_FAILURES" ), nullptr, 10 ) ;
+    if( getenv( "ATHENA_HISTORY"   ) != nullptr ) this->setHistory( getenv( "ATHENA_HISTORY" ) )                        ;
+    if( getenv( "ATHENA_JOURNAL"   ) != nullptr ) this->setJournal( getenv( "ATHENA_JOURNAL" ) )                        ;
+    if( getenv( "ATHENA_REPEAT"    ) != nullptr ) data().repeat  = strtoul( getenv( "ATHENA_REPEAT"  ), nullptr, 10 )   ;
+    if( getenv( "ATHENA_RETRIES"   ) != nullptr ) data().retries = strtoul( getenv( "ATHENA_RETRIES" ), nullptr, 10 )   ;
+    
+    if( getenv( "ATHENA_RERUN" ) != nullptr && !rerunFromName( getenv( "ATHENA_RERUN" ), data().rerun ) )
+    {
+      std::cerr << "athena: Ignoring unknown ATHENA_RERUN " << getenv( "ATHENA_RERUN" ) << "\n" ;
+    }
+    
+    if( getenv( "ATHENA_FILTER" ) != nullptr && !data().filter( getenv( "ATHENA_FILTER" ), false ) )
+    {
+      std::cerr << "athena: Skipping invalid filters of ATHENA_FILTER " << getenv( "ATHENA_FILTER" ) << "\n" ;
+    }
+    
+    if( getenv( "ATHENA_EXCLUDE" ) != nullptr && !data().filter( getenv( "ATHENA_EXCLUDE" ), true ) )
+    {
+      std::cerr << "athena: Skipping invalid filters of ATHENA_EXCLUDE " << getenv( "ATHENA_EXCLUDE" ) << "\n" ;
+    }
+  }
+
+  Manager::~Manager()
+  {
+    delete this->manager_data ;
+  }
+  
+  void Manager::initialize( const char* program_name )
+  {
+    data().program_name = program_name ;
+  }
+
+  bool Manager::initialize( const char* program_name, int argc, char** argv )
+  {
+    std::string argument ;
+    const char* value    ;
+    bool        valid    ;
+    
+    data().program_name = program_name ;
+    valid               = true         ;
+    
+    for( int index = 1; index < argc; index++ )
+    {
+      argument = argv[ index ] ;
+      
+      if( argument == "--fail-fast" )
+      {
+        data().max_failures = 1 ;
+        continue ;
+      }
+      
+      for( const char* option : { "--filter", "--exclude", "--format", "--history", "--journal", "--rerun", "--max-failures", "--repeat", "--retries" } )
+      {
+        if( argument.compare( 0, strlen( option ), option ) != 0 ) continue ;
+        
+        if     ( argument.size() == strlen( option ) && index + 1 < argc ) value = argv[ ++index ]                          ;
+        else if( argument[ strlen( option ) ] == '='                     ) value = argv[ index ] + strlen( option ) + 1 ;
+        else                                                               continue                                         ;
+        
+        if     ( strcmp( option, "--filter"  ) == 0 ) valid = data().filter( value, false )            && valid ;
+        else if( strcmp( option, "--exclude" ) == 0 ) valid = data().filter( value, true  )            && valid ;
+        else if( strcmp( option, "--format"  ) == 0 ) valid = data().format( value )                   && valid ;
+        else if( strcmp( option, "--rerun"   ) == 0 ) valid = rerunFromName( value, data().rerun )     && valid ;
+        else if( strcmp( option, "--history" ) == 0 ) this->setHistory( value )                                 ;
+        else if( strcmp( option, "--journal" ) == 0 ) this->setJournal( value )                                 ;
+        else if( strcmp( option, "--repeat"  ) == 0 ) data().repeat  = strtoul( value, nullptr, 10 )           ;
+        else if( strcmp( option, "--retries" ) == 0 ) data().retries = strtoul( value, nullptr, 10 )           ;
+        else                                          data().max_failures = strtoul( value, nullptr, 10 )      ;
+        break ;
+      }
+    }
+    
+    return valid ;
+  }
+
+  bool Manager::include( const char* pattern )
+  {
+    return data().filter( pattern, false ) ;
+  }
+
+  bool Manager::exclude( const char* pattern )
+  {
+    return data().filter( pattern, true ) ;
+  }
+
+  void Manager::clearFilters()
+  {
+    data().includes.clear() ;
+    data().excludes.clear() ;
+  }
+
+  void Manager::setTag( const char* name, const char* tag )
+  {
+    data().tags[ std::string( tag ) ].insert( std::string( name ) ) ;
+  }
+
+  unsigned Manager::size() const
+  {
+    return data().registry.size() ;
+  }
+
+  void Manager::setSerial( const char* name, bool serial )
+  {
+    if( serial ) data().serial.insert( std::string( name ) ) ;
+    else         data().serial.erase ( std::string( name ) ) ;
+  }
+
+  void Manager::setIsolation( const Isolation& isolation )
+  {
+    data().isolation = isolation ;
+  }
+
+  void Manager::setCounters( bool counters )
+  {
+    data().counters = counters ;
+  }
+
+  void Manager::setJournal( const char* path )
+  {
+    data().journal_path = path != nullptr ? path : "" ;
+  }
+
+  void Manager::setHistory( const char* path )
+  {
+    data().history_path = path                 ;
+    data().fingerprint  = fingerprintProgram() ;
+    
+    data().history.clear() ;
+    loadHistory( path, data().history ) ;
+  }
+
+  void Manager::setRerun( const Rerun& rerun )
+  {
+    data().rerun = rerun ;
+  }
+
+  void Manager::setFailFast( bool fail_fast )
+  {
+    data().max_failures = fail_fast ? 1 : 0 ;
+  }
+
+  void Manager::setMaxFailures( unsigned count )
+  {
+    data().max_failures = count ;
+  }
+
+  void Manager::setRepeat( unsigned count )
+  {
+    data().repeat = count ;
+  }
+
+  void Manager::setRetries( unsigned retries )
+  {
+    data().retries = retries ;
+  }
+
+  void Manager::setTimeout( const char* name, double milliseconds )
+  {
+    data().timeouts[ std::string( name ) ] = milliseconds ;
+  }
+
+  void Manager::setTimeout( double milliseconds )
+  {
+    data().timeout = milliseconds ;
+  }
+
+  void Manager::setBudget( const char* name, std::uint64_t allocations, std::uint64_t bytes )
+  {
+    data().budgets[ std::string( name ) ] = { allocations, bytes } ;
+  }
+
+  void Manager::setDefaultBudget( std::uint64_t allocations, std::uint64_t bytes )
+  {
+    data().budget = { allocations, bytes } ;
+  }
+
+  void Manager::setThroughput( const char* name, std::uint64_t items, std::uint64_t bytes )
+  {
+    data().throughputs[ std::string( name ) ] = { items, bytes } ;
+  }
+
+  void Manager::setComplexity( const char* name, const Complexity& complexity )
+  {
+    data().complexities[ std::string( name ) ] = complexity ;
+  }
+
+  void Manager::setDeadline( double milliseconds )
+  {
+    data().deadline = milliseconds ;
+  }
+
+  void Manager::setShard( unsigned index, unsigned count )
+  {
+    data().shard  = index ;
+    data().shards = count ;
+  }
+
+  bool Manager::setBaseline( const char* path, double threshold, bool fail )
+  {
+    data().baseline.clear() ;
+    data().threshold   = threshold ;
+    data().regressions = fail      ;
+    
+    return loadRecords( path, data().baseline ) ;
+  }
+
+  bool Manager::save( const char* path ) const
+  {
+    return saveRecords( path, data().saved ) ;
+  }
+
+  bool Manager::load( const char* path )
+  {
+    bool finished ;
+    
+    if( loadRecords( path, data().results ) ) return true ;
+    if( !loadJournal( path, data().results, finished ) ) return false ;
+    
+    if( !finished ) std::cerr << "athena: " << path << " is the journal of a run that never finished\n" ;
+    
+    return true ;
+  }
+
+  bool Manager::setFormat( const char* formats )
+  {
+    return data().format( formats ) ;
+  }
+
+  void Manager::addReporter( Reporter* reporter )
+  {
+    data().reporters.push_back( reporter ) ;
+  }
+
+  unsigned Manager::report( const Output& output )
+  {
+    const RecordMap& records = data().results ;
+    
+    if( data().console ) data().console->setOutput( output ) ;
+    data().begin( records.size() ) ;
+    for( const auto& record : records )
+    {
+      data().report( record.first, record.second ) ;
+    }
+    data().end() ;
+    
+    return data().summary.failed ;
+  }
+
+  unsigned Manager::test( const Output& output, unsigned jobs )
+  {
+    if( data().console ) data().console->setOutput( output ) ;
+    data().run( jobs ) ;
+    
+    return data().summary.failed ;
+  }
+
+  void Manager::setSuite( const char* name, Suite* suite )
+  {
+    data().suites.emplace( std::string( name ), suite ) ;
+  }
+
+  void Manager::setVariant( const char* name, const char* variant )
+  {
+    if( !data().groups.emplace( std::string( variant ), std::string( name ) ).second ) return ;
+    
+    data().variants[ name ].push_back( variant ) ;
+  }
+
+  void Manager::setSweep( const char* name, std::uint64_t min, std::uint64_t max, const SizedLoop& loop )
+  {
+    // The registry keeps the first callable of a name, so its sweep must be the first one too.
+    data().sweeps.emplace( std::string( name ), Sweep{ min, max, loop } ) ;
+  }
+
+  void Manager::setContention( const char* name, unsigned threads, const ThreadLoop& loop )
+  {
+    // The registry keeps the first callable of a name, so its threads must be the first ones too.
+    data().contenders.emplace( std::string( name ), Contender{ threads, loop } ) ;
   }
 
-  void Manager::add( const char* name, Callback* callback )
+  Registry& Manager::registry()
   {
-    data().callbacks.insert( { std::string( name ), callback } ) ;
+    return data().registry ;
   }
 
   ManagerData& Manager::data()
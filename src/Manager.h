@@ -15,6 +15,21 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#ifndef ATHENA_MANAGER_H
+#define ATHENA_MANAGER_H
+
+#include "Allocations.h"
+#include "Async.h"
+#include "Benchmark.h"
+#include "Fixture.h"
+#include "Registry.h"
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
 namespace athena
 {
   /** Class to encapsulate a test result.
@@ -27,9 +42,13 @@ namespace athena
        */
       enum
       {
-        Fail = false,
-        Pass = true,
-        Skip = 2,
+        Fail    = false,
+        Pass    = true ,
+        Skip    = 2    ,
+        Crash   = 3    ,
+        Timeout = 4    ,
+        NotRun  = 5    ,
+        Flaky   = 6    ,
       };
       
       /** Default constructor.
@@ -69,7 +88,7 @@ namespace athena
        */
       const char* name() const ;
       
-      /** Method to retrieve the symbol representing this test result for pass, fail, and skip ( ✔, ✗, ■ ).
+      /** Method to retrieve the symbol representing this test result for pass, fail/crash/timeout, skip, not run and flaky ( ✔, ✗, ■, ○, ~ ).
        * @return The ASCII Symbol representing this test result.
        */
       const char* symbol() const ;
@@ -156,15 +175,256 @@ namespace athena
       unsigned enumeration ;
   };
   
+  /** Class to describe why a test crashed or failed instead of returning a result.
+   */
+  class Reason
+  {
+    public:
+      
+      /** Enumeration for this object.
+       */
+      enum
+      {
+        None,
+        Signal,
+        Exit,
+        Regression,
+        Deadline,
+        Budget,
+        Complexity
+      };
+      
+      /** Default constructor.
+       */
+      Reason() ;
+      
+      /** Copy constructor
+       * @param reason The input to copy into this object.
+       */
+      Reason( unsigned reason ) ;
+      
+      /** Conversion operator to convert this reason to an unsigned integer.
+       * @return An unsigned integer representation of this object.
+       */
+      operator unsigned() const ;
+      
+      /** Assignment operator. Assigns this object to the input.
+       * @param reason The unsigned integer to assign this reason to.
+       * @return Reference to this object after assignment.
+       */
+      Reason& operator=( unsigned reason ) ;
+      
+      /** Method to retrieve the string name of this reason.
+       * @return C-string representation of this object's name.
+       */
+      const char* name() const ;
+      
+      /** Method to set this object's value.
+       * @param reason The unsigned integer to set this object to.
+       */
+      void set( unsigned reason ) ;
+      
+      /** Method to retrieve the value of this object.
+       * @return The unsigned-integer representation of this object.
+       */
+      unsigned value() const ;
+    private:
+      
+      /** The internal enumeration of this object.
+       */
+      unsigned enumeration ;
+  };
+  
+  /** Class to handle how tests are isolated from each other while running.
+   */
+  class Isolation
+  {
+    public:
+      
+      /** Enumeration for this object.
+       */
+      enum
+      {
+        None,
+        Process
+      };
+      
+      /** Default constructor.
+       */
+      Isolation() ;
+      
+      /** Copy constructor
+       * @param isolation The input to copy into this object.
+       */
+      Isolation( unsigned isolation ) ;
+      
+      /** Conversion operator to convert this isolation to an unsigned integer.
+       * @return An unsigned integer representation of this object.
+       */
+      operator unsigned() const ;
+      
+      /** Assignment operator. Assigns this object to the input.
+       * @param isolation The unsigned integer to assign this isolation to.
+       * @return Reference to this object after assignment.
+       */
+      Isolation& operator=( unsigned isolation ) ;
+      
+      /** Method to retrieve the string name of this isolation.
+       * @return C-string representation of this object's name.
+       */
+      const char* name() const ;
+      
+      /** Method to set this object's value.
+       * @param isolation The unsigned integer to set this object to.
+       */
+      void set( unsigned isolation ) ;
+      
+      /** Method to retrieve the value of this object.
+       * @return The unsigned-integer representation of this object.
+       */
+      unsigned value() const ;
+    private:
+      
+      /** The internal enumeration of this object.
+       */
+      unsigned enumeration ;
+  };
+  
+  /** Class to handle how a run uses the history of earlier runs.
+   */
+  class Rerun
+  {
+    public:
+      
+      /** Enumeration for this object.
+       */
+      enum
+      {
+        All,
+        FailedFirst,
+        OnlyFailed,
+        SkipPassed
+      };
+      
+      /** Default constructor.
+       */
+      Rerun() ;
+      
+      /** Copy constructor
+       * @param rerun The input to copy into this object.
+       */
+      Rerun( unsigned rerun ) ;
+      
+      /** Conversion operator to convert this rerun to an unsigned integer.
+       * @return An unsigned integer representation of this object.
+       */
+      operator unsigned() const ;
+      
+      /** Assignment operator. Assigns this object to the input.
+       * @param rerun The unsigned integer to assign this rerun to.
+       * @return Reference to this object after assignment.
+       */
+      Rerun& operator=( unsigned rerun ) ;
+      
+      /** Method to retrieve the string name of this rerun.
+       * @return C-string representation of this object's name.
+       */
+      const char* name() const ;
+      
+      /** Method to set this object's value.
+       * @param rerun The unsigned integer to set this object to.
+       */
+      void set( unsigned rerun ) ;
+      
+      /** Method to retrieve the value of this object.
+       * @return The unsigned-integer representation of this object.
+       */
+      unsigned value() const ;
+    private:
+      
+      /** The internal enumeration of this object.
+       */
+      unsigned enumeration ;
+  };
+  
+  /** Class to describe how the time of a benchmark grows with the size of its input.
+   */
+  class Complexity
+  {
+    public:
+      
+      /** Enumeration for this object, from the slowest growing class to the fastest.
+       */
+      enum
+      {
+        None,
+        Constant,
+        Logarithmic,
+        Linear,
+        Linearithmic,
+        Quadratic
+      };
+      
+      /** Default constructor.
+       */
+      Complexity() ;
+      
+      /** Copy constructor
+       * @param complexity The input to copy into this object.
+       */
+      Complexity( unsigned complexity ) ;
+      
+      /** Conversion operator to convert this complexity to an unsigned integer.
+       * @return An unsigned integer representation of this object.
+       */
+      operator unsigned() const ;
+      
+      /** Assignment operator. Assigns this object to the input.
+       * @param complexity The unsigned integer to assign this complexity to.
+       * @return Reference to this object after assignment.
+       */
+      Complexity& operator=( unsigned complexity ) ;
+      
+      /** Method to retrieve the string name of this complexity, in big O notation.
+       * @return C-string representation of this object's name.
+       */
+      const char* name() const ;
+      
+      /** Method to set this object's value.
+       * @param complexity The unsigned integer to set this object to.
+       */
+      void set( unsigned complexity ) ;
+      
+      /** Method to retrieve the value of this object.
+       * @return The unsigned-integer representation of this object.
+       */
+      unsigned value() const ;
+    private:
+      
+      /** The internal enumeration of this object.
+       */
+      unsigned enumeration ;
+  };
+  
+  class Reporter ;
+  
+  /** Function for long running tests to poll, to stop early when their result is no longer wanted.
+   * Becomes true once the run stops after too many failures, or the test times out or passes the deadline. A test running in a
+   * child process is killed instead, so only sees the run stopping if it already had when the child started.
+   * @return Whether or not the calling test should stop.
+   */
+  bool cancelled() ;
+  
   /** Class to manage tests.
    */
   class Manager
   {
     public:
       
-      /** Default constructor.
+      /** Default constructor. Adds every test registered with ATHENA_TEST or ATHENA_BENCHMARK in the executable or library
+       * constructing this object.
        */
-      Manager() ;
+      ATHENA_LOCAL Manager() ;
       
       /** Default deconstructor.
        */
@@ -175,13 +435,52 @@ namespace athena
        */
       void initialize( const char* program_name ) ;
 
+      /** Method to initialize the manager from the command line.
+       * Reads "--filter <filters>", "--exclude <filters>", "--format <formats>", "--history <path>", "--journal <path>",
+       * "--rerun <rerun>", "--max-failures <count>", "--repeat <count>", "--retries <count>" and "--fail-fast". Options with a value
+       * can also be written as "--filter=<filters>".
+       * Other arguments are left for the program.
+       * @param program_name The name of the program/product being tested.
+       * @param argc The amount of arguments.
+       * @param argv The arguments, starting with the program's path.
+       * @return Whether every option had a valid value.
+       */
+      bool initialize( const char* program_name, int argc, char** argv ) ;
+
+      /** Method to only run tests matching a filter. A test runs when it matches any include filter and no exclude filter.
+       * Filters are globs ( "object_*" ), "re:" followed by a regex matching whole names, or "tag:" followed by a tag.
+       * The ATHENA_FILTER and ATHENA_EXCLUDE environment variables add comma-separated filters the same way.
+       * @param pattern The filter to include tests with.
+       * @return Whether or not the filter is valid.
+       */
+      bool include( const char* pattern ) ;
+
+      /** Method to skip tests matching a filter, even if an include filter matches them.
+       * @param pattern The filter to exclude tests with. See include for its syntax.
+       * @return Whether or not the filter is valid.
+       */
+      bool exclude( const char* pattern ) ;
+
+      /** Method to remove every include and exclude filter, running every test again.
+       */
+      void clearFilters() ;
+
+      /** Method to tag a test, so it can be selected with a "tag:" filter.
+       * @param name The name of the test.
+       * @param tag The tag to give it. A test can have any amount of tags.
+       */
+      void setTag( const char* name, const char* tag ) ;
+
       /** Method to add a test callback to this object.
+       * Anything callable with no arguments can be added: functions, lambdas and capturing functors. Small callables are
+       * stored without any allocation of their own. A name that is already added keeps its first callback.
+       * A callable returning an athena::Task is a coroutine test, run on an executor alongside every other coroutine test
+       * of the run, in the same process even with Isolation::Process.
        * @param name The name of the test to associate with the callback.
-       * @param callback The function to assess as a test.
+       * @param callback The callable to assess as a test. Returns a Result, a bool, an athena::Task, or nothing to always pass.
        */
-      template<typename TYPE>
-      void add( const char* name, TYPE (*callback)() ) ;
-
+      template<typename CALLABLE>
+      void add( const char* name, CALLABLE&& callback ) ;
       
       /** Method to add a test method callback to this object.
        * @param name The name of the test to associate with the callback.
@@ -191,70 +490,311 @@ namespace athena
       template< typename OBJECT, typename TYPE>
       void add( const char* name, OBJECT* obj, TYPE (OBJECT::*callback)() ) ;
       
+      /** Method to add a test of a suite to this object. The test is given the suite's fixture when it runs.
+       * The fixture is set up the first time one of its tests runs, and torn down once its last test of the run is done.
+       * Its set up time counts towards the test that needed it first.
+       * @param name The name of the test to associate with the callback.
+       * @param fixture The fixture of the suite the test belongs to.
+       * @param callback The callable to assess as a test, taking a reference to the fixture.
+       */
+      template<typename FIXTURE, typename CALLABLE>
+      void add( const char* name, Fixture<FIXTURE>& fixture, CALLABLE&& callback ) ;
+      
+      /** Method to add a parameterized test, running the callback once for every input of a table.
+       * The whole table is a single registration: its cases are named lazily as they are reported, e.g. "parse[42]" for the
+       * 43rd input, and are handed to workers in batches. Every case is reported with its own result and time.
+       * @param name The name of the test. Filters, timeouts and shards apply to every case of the test at once.
+       * @param inputs The inputs, in a container with random access such as a std::vector or std::array. Stored by copy,
+       *               or moved when given as an rvalue. An empty container adds nothing.
+       * @param callback The callable to assess each case with, taking an input. Returns a Result, a bool, or nothing.
+       */
+      template<typename RANGE, typename CALLABLE, typename = typename std::enable_if<!std::is_integral<typename std::decay<RANGE>::type>::value>::type>
+      void addCases( const char* name, RANGE&& inputs, CALLABLE&& callback ) ;
+
+      /** Method to add a parameterized test generating its own inputs, running the callback once for every case index.
+       * @param name The name of the test.
+       * @param count The amount of cases. Zero adds nothing.
+       * @param callback The callable to assess each case with, taking the index of the case.
+       */
+      template<typename CALLABLE>
+      void addCases( const char* name, unsigned count, CALLABLE&& callback ) ;
+      
+      /** Method to add a benchmark callback to this object.
+       * Benchmarks run one at a time after every test, and report timing statistics instead of a single time.
+       * @param name The name of the benchmark to associate with the callback.
+       * @param callback The callable to benchmark. Its return value is kept from being optimized away.
+       */
+      template<typename CALLABLE>
+      void benchmark( const char* name, CALLABLE&& callback ) ;
+      
+      /** Method to add a benchmark method callback to this object.
+       * @param name The name of the benchmark to associate with the callback.
+       * @param object The object to call the callback function with.
+       * @param callback The function to benchmark. Its return value is kept from being optimized away.
+       */
+      template< typename OBJECT, typename TYPE>
+      void benchmark( const char* name, OBJECT* obj, TYPE (OBJECT::*callback)() ) ;
+      
+      /** Method to add a variant of a benchmark, to be compared against the benchmark's other variants.
+       * Each variant is a benchmark named "<name>/<variant>". Variants running in the same run are measured together, their
+       * samples interleaved to cancel out drift, and each reports its speedup over the first variant added with a 95%
+       * bootstrap confidence interval. A speedup whose interval includes no change is reported as inconclusive.
+       * @param name The name of the benchmark.
+       * @param variant The name of the variant.
+       * @param callback The callable to benchmark. Its return value is kept from being optimized away.
+       */
+      template<typename CALLABLE>
+      void variant( const char* name, const char* variant, CALLABLE&& callback ) ;
+      
+      /** Method to add a benchmark measured over a sweep of input sizes, to fit how its time grows with the size.
+       * The sizes double from the smallest to the largest, and the sweep is fitted to every Complexity class. The benchmark's
+       * statistics, counters and allocations are those of the largest size.
+       * @param name The name of the benchmark to associate with the callback.
+       * @param min The smallest size to measure.
+       * @param max The largest size to measure.
+       * @param callback The callable to benchmark, taking the size as a std::uint64_t. Its return value is kept from being optimized away.
+       */
+      template<typename CALLABLE>
+      void complexity( const char* name, std::uint64_t min, std::uint64_t max, CALLABLE&& callback ) ;
+      
+      /** Method to add a benchmark run on 1, 2, 4 and so on up to a number of threads at once, to measure it under contention.
+       * The threads of each amount start together from a spin barrier. Every amount reports its total throughput, its
+       * scaling efficiency against a single thread and the median and tail time of an iteration. The benchmark's statistics
+       * are those of a single thread.
+       * @param name The name of the benchmark to associate with the callback.
+       * @param threads The most threads to run at once. Zero uses every hardware thread.
+       * @param callback The callable to benchmark, called from every thread at once. May take the thread's index, from zero, as an unsigned.
+       */
+      template<typename CALLABLE>
+      void contention( const char* name, unsigned threads, CALLABLE&& callback ) ;
+      
       /** Method to retrieve the number of tests being performed by this object.
        * @return 
        */
       unsigned size() const ;
       
+      /** Method to mark a test as unable to run alongside other tests.
+       * Serial tests run one at a time on a pool of a single worker once every parallel test has finished. That worker is the
+       * calling thread, unless a timeout or deadline is set: the watchdog then runs each test on a thread it can abandon.
+       * @param name The name of the test to mark. Must already be added.
+       * @param serial Whether or not the test must run by itself.
+       */
+      void setSerial( const char* name, bool serial = true ) ;
+      
+      /** Method to set how tests are isolated from each other.
+       * With Isolation::Process every test runs in a child process, so a crash is recorded instead of ending the run.
+       * Only available on unix platforms, others always run tests in-process.
+       * @param isolation The isolation to use for following calls to test.
+       */
+      void setIsolation( const Isolation& isolation ) ;
+      
+      /** Method to count hardware events around every test and benchmark: cycles, instructions, branch misses, and L1 and
+       * last level cache misses. Verbose output and the JUnit and JSON Lines formats show them per iteration, with the
+       * instructions per cycle. Only available on Linux when perf events are allowed, otherwise tests run uncounted.
+       * Also enabled by setting the ATHENA_COUNTERS environment variable to anything but 0.
+       * @param counters Whether or not to count hardware events in following calls to test.
+       */
+      void setCounters( bool counters ) ;
+      
+      /** Method to keep the outcome and time of every test in a history file, updated after each run.
+       * Each entry remembers a fingerprint of the program it ran in, so a rebuilt program doesn't trust old passes.
+       * Also set by the ATHENA_HISTORY environment variable, or the --history option.
+       * @param path The path of the history file. Loaded now if it exists.
+       */
+      void setHistory( const char* path ) ;
+      
+      /** Method to journal the record of every test as it finishes, to a binary file that survives the process crashing.
+       * The journal is rewritten by every run, and can be turned into a report with load, or the athena_report tool, even
+       * when its run never finished. Also set by the ATHENA_JOURNAL environment variable, or the --journal option.
+       * @param path The path of the journal file. Empty stops journaling.
+       */
+      void setJournal( const char* path ) ;
+      
+      /** Method to set how following runs use the history set with setHistory.
+       * Rerun::FailedFirst runs and reports the tests that failed last time before the others. Rerun::OnlyFailed only runs
+       * them, or every test when none failed. Rerun::SkipPassed skips the tests that passed last time in the same build.
+       * Also set by the ATHENA_RERUN environment variable or the --rerun option, as failed-first, only-failed or skip-passed.
+       * @param rerun How to use the history.
+       */
+      void setRerun( const Rerun& rerun ) ;
+      
+      /** Method to stop a run at its first failure. The same as a single allowed failure with setMaxFailures.
+       * Also set by the ATHENA_FAIL_FAST environment variable, or the --fail-fast option.
+       * @param fail_fast Whether or not to stop at the first failure.
+       */
+      void setFailFast( bool fail_fast ) ;
+      
+      /** Method to stop a run once a number of its tests have failed. Tests that haven't started yet are reported as
+       * Result::NotRun, and tests still running see athena::cancelled() become true.
+       * Also set by the ATHENA_MAX_FAILURES environment variable, or the --max-failures option.
+       * @param count The amount of failures to stop after. Zero never stops.
+       */
+      void setMaxFailures( unsigned count ) ;
+      
+      /** Method to run every test of following runs several times, to find the ones that don't always have the same outcome.
+       * The runs of a test follow each other on the worker that picked it up, while other tests run on the other workers.
+       * A test that both passed and failed is reported as Result::Flaky, along with how many runs passed, the first run that
+       * failed and the distribution of the runs' times. Its timeout covers all of its runs. Benchmarks and coroutine tests
+       * run once. Also set by the ATHENA_REPEAT environment variable, or the --repeat option.
+       * @param count The amount of times to run each test. Zero or one runs each test once.
+       */
+      void setRepeat( unsigned count ) ;
+      
+      /** Method to rerun a test of following runs while it fails, until it passes or runs out of retries.
+       * A test that passes on a retry is reported as Result::Flaky, with the amount of retries it took. Retries only follow
+       * the repeated runs of setRepeat when every one of them failed.
+       * Also set by the ATHENA_RETRIES environment variable, or the --retries option.
+       * @param retries The most times to rerun a failing test. Zero never reruns.
+       */
+      void setRetries( unsigned retries ) ;
+      
+      /** Method to set the time a single test may run before it times out, overriding the default timeout.
+       * With Isolation::Process a timed out test's child is killed. Otherwise its thread is abandoned to finish on its own
+       * while the run moves on, so the test must not rely on anything destroyed after test returns, such as the captures
+       * of a lambda, which are destroyed with this object.
+       * Benchmarks are never timed out.
+       * @param name The name of the test.
+       * @param milliseconds The time the test may run. Zero lets it run forever.
+       */
+      void setTimeout( const char* name, double milliseconds ) ;
+      
+      /** Method to set the time every test without a timeout of its own may run before it times out.
+       * @param milliseconds The time each test may run. Zero lets them run forever.
+       */
+      void setTimeout( double milliseconds ) ;
+      
+      /** Method to set the allocation budget of a test, overriding the default budget. A test that passes but allocates
+       * more than its budget fails with Reason::Budget. A benchmark's budget applies to a single iteration.
+       * Budgets are only enforced in programs linked with the athena_allocations library, which tracks allocations.
+       * @param name The name of the test.
+       * @param allocations The most allocations the test may make, e.g. zero for a hot path.
+       * @param bytes The most bytes the test may have allocated at once.
+       */
+      void setBudget( const char* name, std::uint64_t allocations, std::uint64_t bytes = BUDGET_UNLIMITED ) ;
+      
+      /** Method to set the allocation budget of every test without a budget of its own.
+       * @param allocations The most allocations each test may make. BUDGET_UNLIMITED for no limit.
+       * @param bytes The most bytes each test may have allocated at once.
+       */
+      void setDefaultBudget( std::uint64_t allocations, std::uint64_t bytes = BUDGET_UNLIMITED ) ;
+      
+      /** Method to set how much work one iteration of a benchmark does, to report its items and bytes per second.
+       * For a benchmark swept over sizes, the amounts are per unit of size, and the rates are those of the largest size.
+       * @param name The name of the benchmark.
+       * @param items The items one iteration processes.
+       * @param bytes The bytes one iteration processes.
+       */
+      void setThroughput( const char* name, std::uint64_t items, std::uint64_t bytes = 0 ) ;
+      
+      /** Method to set the complexity a benchmark swept over sizes is expected to have. A sweep whose time grows faster than
+       * expected fails with Reason::Complexity, so accidentally quadratic work is caught. Growing slower still passes.
+       * @param name The name of the benchmark.
+       * @param complexity The fastest growing complexity the benchmark may have.
+       */
+      void setComplexity( const char* name, const Complexity& complexity ) ;
+      
+      /** Method to set the time a whole call to test may take.
+       * Once it passes, running tests are stopped and every test left times out with Reason::Deadline.
+       * @param milliseconds The time the run may take. Zero lets it run forever.
+       */
+      void setDeadline( double milliseconds ) ;
+      
+      /** Method to run only one shard of the added tests, so a suite can be split over several processes or machines.
+       * A test belongs to shard hash( name ) % count, which doesn't depend on the order tests were added in.
+       * @param index The index of the shard to run, from 0 to @p count - 1.
+       * @param count The amount of shards the suite is split into. One runs every test.
+       */
+      void setShard( unsigned index, unsigned count ) ;
+      
+      /** Method to load a baseline to compare the timing of following test runs against.
+       * Benchmarks compare their median and must differ by more than the noise of both runs, tests compare their single time.
+       * @param path The path of a result file saved by a previous run.
+       * @param threshold How much slower than its baseline a test may get before it regresses, as a fraction ( 0.1 is 10% ).
+       * @param fail Whether a regression fails its test, or is only flagged in the report.
+       * @return Whether or not the baseline was loaded.
+       */
+      bool setBaseline( const char* path, double threshold = 0.1, bool fail = false ) ;
+      
+      /** Method to save the results of the last test run or report, e.g. as the baseline of later runs.
+       * @param path The path of the result file to write.
+       * @return Whether or not the file was written.
+       */
+      bool save( const char* path ) const ;
+      
+      /** Method to merge the results of a saved result file, e.g. of another shard, into this object's results.
+       * Journals written with setJournal are read too, with whatever tests finished before their run stopped.
+       * @param path The path of the result file or journal to read.
+       * @return Whether or not the file was read.
+       */
+      bool load( const char* path ) ;
+      
+      /** Method to choose the formats following runs are reported in. Several formats can be written at once.
+       * Known formats are console, junit ( JUnit XML ) and jsonl ( JSON Lines ), each optionally followed by '=' and the path of
+       * the file to write, e.g. "console,junit=results.xml". Without a path a format writes to the standard output.
+       * Defaults to the ATHENA_FORMAT environment variable when set, and "console" otherwise.
+       * @param formats Comma-separated list of formats.
+       * @return Whether every format was known and its file could be opened. Otherwise the formats are left unchanged.
+       */
+      bool setFormat( const char* formats ) ;
+      
+      /** Method to add a reporter to recieve the events of every following run, alongside the chosen formats.
+       * Events of tests running in parallel are never delivered concurrently.
+       * @param reporter The reporter to add. Not owned, so it must outlive this object's runs.
+       */
+      void addReporter( Reporter* reporter ) ;
+      
+      /** Method to print the report of the results loaded into this object without running any tests.
+       * @param output The desired way to output the results.
+       * @return The number of failed tests.
+       */
+      unsigned report( const Output& output ) ;
+      
       /** Method to perform all tests recorded in this objecct.
        * @param output The desired way to output this object's tests.
-       * @return The number of passed
+       * @param jobs The amount of tests ( threads or child processes ) to run at once. Zero uses every hardware thread.
+       * @return The number of failed tests.
        */
-      unsigned test( const Output& output ) ;
+      unsigned test( const Output& output, unsigned jobs = 1 ) ;
     private:
       
-      /** Virtual class to encapsulate a callback.
+      /** Method to create this object's internal data. Called by the constructor, which is inline so it sees the tests of the
+       * module constructing this object.
        */
-      class Callback
-      {
-        public:
-          virtual ~Callback() = default ;
-          
-          virtual Result test() = 0 ;
-      };
+      void construct() ;
       
-      /** Template class to encapsulate a function callback.
+      /** Method to associate a test with the suite whose fixture it uses.
+       * @param name The name of the test.
+       * @param suite The suite of the test.
        */
-      template<typename TYPE>
-      class Function : public Callback
-      {
-        public:
-          typedef TYPE ( *Callback )() ;
-          
-          Function( Callback callback ) ;
-          ~Function() = default ;
-          Result test() ;
-        private:
-          Callback callback ;
-      };
+      void setSuite( const char* name, Suite* suite ) ;
       
+      /** Method to associate a benchmark with the benchmark it is a variant of.
+       * @param name The name of the benchmark the variant belongs to.
+       * @param variant The full name of the variant's benchmark.
+       */
+      void setVariant( const char* name, const char* variant ) ;
       
-      /** Template class to encapsulate a method callback.
+      /** Method to associate a benchmark with the sweep of sizes it is measured over. A name keeps its first sweep, as it
+       * keeps its first callable.
+       * @param name The name of the benchmark.
+       * @param min The smallest size to measure.
+       * @param max The largest size to measure.
+       * @param loop The loop running the benchmark on an input of a size.
        */
-      template<typename OBJECT, typename TYPE>
-      class Method : public Callback
-      {
-        public:
-          
-          typedef TYPE ( OBJECT::*Callback )() ;
-          
-          Method( OBJECT* object, Callback callback ) ;
-          
-          ~Method() = default ;
-          
-          Result test() ;
-        private:
-          
-          OBJECT*  object   ;
-          Callback callback ;
-      };
+      void setSweep( const char* name, std::uint64_t min, std::uint64_t max, const SizedLoop& loop ) ;
       
-      /** Method to add a callback to this object's callback map.
-       * @param name The name associated with the test.
-       * @param callback The test callback to use for testing.
+      /** Method to associate a benchmark with the threads it is run on at once. A name keeps its first threads, as it
+       * keeps its first callable.
+       * @param name The name of the benchmark.
+       * @param threads The most threads to run at once. Zero uses every hardware thread.
+       * @param loop The loop running the benchmark on a thread.
        */
-      void add( const char* name, Callback* callback ) ;
+      void setContention( const char* name, unsigned threads, const ThreadLoop& loop ) ;
       
+      /** Method to retrieve the registry holding this object's tests.
+       * @return Reference to this object's registry.
+       */
+      Registry& registry() ;
       
       /** Forward-declared structure to contain this object's internal data.
        */
@@ -275,40 +815,145 @@ namespace athena
       const ManagerData& data() const ;
   };
   
-  template<typename TYPE>
-  Manager::Function<TYPE>::Function( Callback callback )
+  inline Manager::Manager()
   {
-    this->callback = callback ;
+    this->construct() ;
+#ifdef ATHENA_SECTION_TABLE
+    this->registry().add( __start_athena_tests, __stop_athena_tests ) ;
+#else
+    for( const Link* link = links; link != nullptr; link = link->next )
+    {
+      this->registry().add( &link->descriptor, &link->descriptor + 1 ) ;
+    }
+#endif
   }
   
-  template<typename TYPE>
-  Result Manager::Function<TYPE>::test()
+  template<typename CALLABLE>
+  void Manager::add( const char* name, CALLABLE&& callback )
   {
-    return static_cast<Result>( ( this->callback )() ) ;
+    this->registry().add( name, std::forward<CALLABLE>( callback ), false ) ;
   }
   
   template<typename OBJECT, typename TYPE>
-  Manager::Method<OBJECT, TYPE>::Method( OBJECT* object, Callback callback )
+  void Manager::add( const char* name, OBJECT* object, TYPE ( OBJECT::*callback )() )
   {
-    this->callback = callback ;
-    this->object   = object   ;
+    this->registry().add( name, [object, callback]() { return ( object->*callback )() ; }, false ) ;
   }
-  
-  template<typename TYPE>
-  void Manager::add( const char* name, TYPE (*callback)() )
+
+  template<typename FIXTURE, typename CALLABLE>
+  void Manager::add( const char* name, Fixture<FIXTURE>& fixture, CALLABLE&& callback )
   {
-    this->add( name, dynamic_cast<Manager::Callback*>( new Manager::Function<TYPE>( callback ) ) ) ;
+    Suite* suite = &fixture ;
+    
+    this->registry().add( name, [suite, callback = std::forward<CALLABLE>( callback )]() mutable
+    {
+      Suite::Lease lease( *suite ) ;
+      
+      return callback( *static_cast<FIXTURE*>( lease.get() ) ) ;
+    }, false ) ;
+    
+    this->setSuite( name, suite ) ;
   }
-  
-  template<typename OBJECT, typename TYPE>
-  void Manager::add( const char* name, OBJECT* object, TYPE ( OBJECT::*callback )() )
+
+  template<typename RANGE, typename CALLABLE, typename>
+  void Manager::addCases( const char* name, RANGE&& inputs, CALLABLE&& callback )
+  {
+    typedef typename std::decay<RANGE>::type TYPE ;
+    
+    const unsigned count = static_cast<unsigned>( std::size( inputs ) ) ;
+    
+    if( count == 0 ) return ;
+    
+    this->registry().add( name, [inputs = TYPE( std::forward<RANGE>( inputs ) ), callback = std::forward<CALLABLE>( callback )]( std::size_t item ) mutable
+    {
+      return callback( *( std::begin( inputs ) + item ) ) ;
+    }, false, count ) ;
+  }
+
+  template<typename CALLABLE>
+  void Manager::addCases( const char* name, unsigned count, CALLABLE&& callback )
   {
-    this->add( name, dynamic_cast<Manager::Callback*>( new Manager::Method<OBJECT, TYPE>( object, callback ) ) ) ;
+    if( count == 0 ) return ;
+    
+    this->registry().add( name, std::forward<CALLABLE>( callback ), false, count ) ;
   }
 
+  template<typename CALLABLE>
+  void Manager::benchmark( const char* name, CALLABLE&& callback )
+  {
+    this->registry().add( name, std::forward<CALLABLE>( callback ), true ) ;
+  }
+  
   template<typename OBJECT, typename TYPE>
-  Result Manager::Method<OBJECT, TYPE>::test()
+  void Manager::benchmark( const char* name, OBJECT* object, TYPE ( OBJECT::*callback )() )
   {
-    return static_cast<Result>( ( ( this->object )->*( this->callback ) )() ) ;
+    this->registry().add( name, [object, callback]() { return ( object->*callback )() ; }, true ) ;
   }
-}
\ No newline at end of file
+  
+  template<typename CALLABLE>
+  void Manager::variant( const char* name, const char* variant, CALLABLE&& callback )
+  {
+    const std::string full = std::string( name ) + "/" + variant ;
+    
+    this->registry().add( full.c_str(), std::forward<CALLABLE>( callback ), true ) ;
+    this->setVariant( name, full.c_str() ) ;
+  }
+  
+  template<typename CALLABLE>
+  void Manager::complexity( const char* name, std::uint64_t min, std::uint64_t max, CALLABLE&& callback )
+  {
+    typedef typename std::decay<CALLABLE>::type TYPE ;
+    
+    auto shared = std::make_shared<TYPE>( std::forward<CALLABLE>( callback ) ) ;
+    
+    // The benchmark itself is the largest size, so everything measured once per benchmark describes the sweep's end.
+    this->registry().add( name, [shared, max]() { return ( *shared )( max ) ; }, true ) ;
+    this->setSweep( name, min, max, [shared]( std::uint64_t size, std::uint64_t iterations )
+    {
+      for( std::uint64_t iteration = 0; iteration < iterations; iteration++ )
+      {
+        if constexpr( std::is_void<decltype( ( *shared )( size ) )>::value )
+        {
+          ( *shared )( size ) ;
+          clobberMemory() ;
+        }
+        else
+        {
+          doNotOptimize( ( *shared )( size ) ) ;
+        }
+      }
+    } ) ;
+  }
+  
+  template<typename CALLABLE>
+  void Manager::contention( const char* name, unsigned threads, CALLABLE&& callback )
+  {
+    typedef typename std::decay<CALLABLE>::type TYPE ;
+    
+    auto shared = std::make_shared<TYPE>( std::forward<CALLABLE>( callback ) ) ;
+    auto call   = []( auto& callable, unsigned thread ) -> decltype( auto )
+    {
+      if constexpr( std::is_invocable<decltype( callable ), unsigned>::value ) return callable( thread ) ;
+      else                                                                     return callable()       ;
+    } ;
+    
+    this->registry().add( name, [shared, call]() { return call( *shared, 0 ) ; }, true ) ;
+    this->setContention( name, threads, [shared, call]( unsigned thread, std::uint64_t iterations )
+    {
+      for( std::uint64_t iteration = 0; iteration < iterations; iteration++ )
+      {
+        if constexpr( std::is_void<decltype( call( *shared, thread ) )>::value )
+        {
+          call( *shared, thread ) ;
+          clobberMemory() ;
+        }
+        else
+        {
+          doNotOptimize( call( *shared, thread ) ) ;
+        }
+      }
+    } ) ;
+  }
+}
+
+#endif
@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Pool.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace athena
+{
+  /** Alias for a chrono time point since that name is super long.
+   */
+  typedef std::chrono::steady_clock::time_point TimePoint ;
+
+  /** The longest time in milliseconds the watchdog sleeps between checks when no limit is closer.
+   */
+  constexpr double WATCHDOG_PERIOD = 50.0 ;
+
+  /** Structure to contain what a worker of a watched run is currently doing.
+   */
+  struct Watcher
+  {
+    TimePoint begin      ; ///< When the worker started its current task.
+    unsigned  task       ; ///< The task the worker is running.
+    unsigned  generation ; ///< Bumped whenever the worker is abandoned, so the abandoned thread knows it was replaced.
+    bool      busy       ; ///< Whether or not the worker is running a task.
+  };
+
+  /** Structure to contain the state of a watched run. Shared with every worker thread, so abandoned workers can outlive the run.
+   */
+  struct Watch
+  {
+    std::mutex              lock     ;
+    std::condition_variable finished ;
+    std::vector<Watcher>    watchers ;
+    Pool::Job               job      ;
+    unsigned                active   ;
+  };
+
+  /** Structure to contain a single worker's queue of tasks.
+   */
+  struct Queue
+  {
+    std::mutex           lock  ;
+    std::deque<unsigned> tasks ;
+  };
+
+  struct PoolData
+  {
+    std::unique_ptr<Queue[]> queues  ;
+    unsigned                 workers ;
+    unsigned                 next    ;
+
+    /** Default constructor.
+     */
+    PoolData() ;
+
+    /** Method to pop the next task of a worker, stealing from the other workers when its own queue is empty.
+     * @param worker The worker to retrieve a task for.
+     * @param task Reference to the task to set.
+     * @return Whether or not a task was found.
+     */
+    bool pop( unsigned worker, unsigned& task ) ;
+
+    /** Method to run a worker until no tasks remain in any queue.
+     * @param worker The index of the worker.
+     * @param job The function to call for every task.
+     */
+    void work( unsigned worker, const Pool::Job& job ) ;
+
+    /** Method to run a worker of a watched run until no tasks remain, or until it is abandoned.
+     * @param watch The state of the watched run.
+     * @param worker The index of the worker.
+     * @param generation The generation of the worker when this thread started.
+     */
+    void watched( std::shared_ptr<Watch> watch, unsigned worker, unsigned generation ) ;
+
+    /** Method to remove every task still queued.
+     * @param tasks The vector to move the removed tasks into.
+     */
+    void drain( std::vector<unsigned>& tasks ) ;
+  };
+
+  PoolData::PoolData()
+  {
+    this->workers = 0 ;
+    this->next    = 0 ;
+  }
+
+  bool PoolData::pop( unsigned worker, unsigned& task )
+  {
+    unsigned victim ;
+
+    // Own queue is consumed from the front, in the order tasks were pushed.
+    {
+      std::lock_guard<std::mutex> guard( this->queues[ worker ].lock ) ;
+      if( !this->queues[ worker ].tasks.empty() )
+      {
+        task = this->queues[ worker ].tasks.front() ;
+        this->queues[ worker ].tasks.pop_front() ;
+        return true ;
+      }
+    }
+
+    // Steal from the back of the other queues so the victim keeps the tasks it is about to run.
+    for( unsigned offset = 1; offset < this->workers; offset++ )
+    {
+      victim = ( worker + offset ) % this->workers ;
+
+      std::lock_guard<std::mutex> guard( this->queues[ victim ].lock ) ;
+      if( !this->queues[ victim ].tasks.empty() )
+      {
+        task = this->queues[ victim ].tasks.back() ;
+        this->queues[ victim ].tasks.pop_back() ;
+        return true ;
+      }
+    }
+
+    return false ;
+  }
+
+  void PoolData::work( unsigned worker, const Pool::Job& job )
+  {
+    unsigned task ;
+
+    while( this->pop( worker, task ) )
+    {
+      job( task, worker ) ;
+    }
+  }
+
+  void PoolData::watched( std::shared_ptr<Watch> watch, unsigned worker, unsigned generation )
+  {
+    unsigned task ;
+
+    while( this->pop( worker, task ) )
+    {
+      {
+        std::lock_guard<std::mutex> guard( watch->lock ) ;
+        watch->watchers[ worker ].task  = task                             ;
+        watch->watchers[ worker ].begin = std::chrono::steady_clock::now() ;
+        watch->watchers[ worker ].busy  = true                             ;
+      }
+
+      watch->job( task, worker ) ;
+
+      {
+        // Once abandoned, the pool may already be gone, so only the shared watch state may be touched.
+        std::lock_guard<std::mutex> guard( watch->lock ) ;
+        if( watch->watchers[ worker ].generation != generation ) return ;
+        watch->watchers[ worker ].busy = false ;
+      }
+    }
+
+    std::lock_guard<std::mutex> guard( watch->lock ) ;
+    watch->active-- ;
+    watch->finished.notify_all() ;
+  }
+
+  void PoolData::drain( std::vector<unsigned>& tasks )
+  {
+    for( unsigned worker = 0; worker < this->workers; worker++ )
+    {
+      std::lock_guard<std::mutex> guard( this->queues[ worker ].lock ) ;
+      tasks.insert( tasks.end(), this->queues[ worker ].tasks.begin(), this->queues[ worker ].tasks.end() ) ;
+      this->queues[ worker ].tasks.clear() ;
+    }
+  }
+
+  Pool::Pool()
+  {
+    this->pool_data = new PoolData() ;
+    this->initialize( 1 ) ;
+  }
+
+  Pool::~Pool()
+  {
+    delete this->pool_data ;
+  }
+
+  void Pool::initialize( unsigned workers )
+  {
+    if( workers == 0 ) workers = std::thread::hardware_concurrency() ;
+    if( workers == 0 ) workers = 1                                   ;
+
+    data().queues.reset( new Queue[ workers ] ) ;
+    data().workers = workers ;
+    data().next    = 0       ;
+  }
+
+  unsigned Pool::size() const
+  {
+    return data().workers ;
+  }
+
+  void Pool::push( unsigned task )
+  {
+    data().queues[ data().next ].tasks.push_back( task ) ;
+    data().next = ( data().next + 1 ) % data().workers ;
+  }
+
+  void Pool::run( const Job& job )
+  {
+    std::vector<std::thread> threads ;
+
+    for( unsigned worker = 1; worker < data().workers; worker++ )
+    {
+      threads.emplace_back( [this, worker, &job]() { data().work( worker, job ) ; } ) ;
+    }
+
+    data().work( 0, job ) ;
+
+    for( auto& thread : threads )
+    {
+      thread.join() ;
+    }
+
+    data().next = 0 ;
+  }
+
+  void Pool::run( const Job& job, const Limit& limit, const Expire& expire, double deadline )
+  {
+    std::shared_ptr<Watch> watch    ;
+    std::vector<unsigned>  expired  ;
+    TimePoint              start    ;
+    TimePoint              now      ;
+    double                 elapsed  ;
+    double                 allowed  ;
+    double                 wait     ;
+    bool                   stopped  ;
+
+    watch         = std::make_shared<Watch>()         ;
+    watch->job    = job                               ;
+    watch->active = data().workers                    ;
+    watch->watchers.resize( data().workers, Watcher() ) ;
+
+    start   = std::chrono::steady_clock::now() ;
+    stopped = false                            ;
+
+    std::unique_lock<std::mutex> guard( watch->lock ) ;
+    for( unsigned worker = 0; worker < data().workers; worker++ )
+    {
+      std::thread( &PoolData::watched, this->pool_data, watch, worker, 0u ).detach() ;
+    }
+
+    while( watch->active > 0 )
+    {
+      now  = std::chrono::steady_clock::now() ;
+      wait = WATCHDOG_PERIOD                  ;
+
+      if( deadline > 0.0 && !stopped )
+      {
+        elapsed = std::chrono::duration<double, std::milli>( now - start ).count() ;
+        if( elapsed >= deadline )
+        {
+          stopped = true ;
+          data().drain( expired ) ;
+          for( unsigned task : expired ) expire( task, 0.0 ) ;
+        }
+        else
+        {
+          wait = std::min( wait, deadline - elapsed ) ;
+        }
+      }
+
+      for( unsigned worker = 0; worker < data().workers; worker++ )
+      {
+        Watcher& watcher = watch->watchers[ worker ] ;
+        if( !watcher.busy ) continue ;
+
+        elapsed = std::chrono::duration<double, std::milli>( now - watcher.begin ).count() ;
+        allowed = limit( watcher.task ) ;
+
+        if( stopped || ( allowed > 0.0 && elapsed >= allowed ) )
+        {
+          // The task may have just finished, in which case its worker is left alone.
+          if( expire( watcher.task, elapsed ) )
+          {
+            watcher.generation++    ;
+            watcher.busy   = false  ;
+
+            if( stopped ) watch->active-- ;
+            else          std::thread( &PoolData::watched, this->pool_data, watch, worker, watcher.generation ).detach() ;
+          }
+        }
+        else if( allowed > 0.0 )
+        {
+          wait = std::min( wait, allowed - elapsed ) ;
+        }
+      }
+
+      if( watch->active > 0 )
+      {
+        watch->finished.wait_for( guard, std::chrono::duration<double, std::milli>( std::max( wait, 0.1 ) ) ) ;
+      }
+    }
+
+    data().next = 0 ;
+  }
+
+  PoolData& Pool::data()
+  {
+    return *this->pool_data ;
+  }
+
+  const PoolData& Pool::data() const
+  {
+    return *this->pool_data ;
+  }
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATHENA_POOL_H
+#define ATHENA_POOL_H
+
+#include <functional>
+
+namespace athena
+{
+  /** Class to run a batch of indexed tasks across a set of worker threads.
+   * Each worker owns a queue of tasks and steals from the other workers' queues once its own runs dry.
+   */
+  class Pool
+  {
+    public:
+
+      /** The function called for every task. Recieves the task index and the index of the worker running it.
+       */
+      typedef std::function<void( unsigned task, unsigned worker )> Job ;
+
+      /** The function deciding how long a task may run before it times out, in milliseconds. Zero lets it run forever.
+       */
+      typedef std::function<double( unsigned task )> Limit ;
+
+      /** The function called by the watchdog when a task runs past its limit or the deadline, with the time it ran for in milliseconds.
+       * Returns whether the task was still unfinished, in which case its worker is abandoned and replaced.
+       */
+      typedef std::function<bool( unsigned task, double elapsed )> Expire ;
+
+      /** Default constructor.
+       */
+      Pool() ;
+
+      /** Default deconstructor.
+       */
+      ~Pool() ;
+
+      /** Method to initialize this pool with a number of workers.
+       * @param workers The amount of workers to use. Zero uses every hardware thread.
+       */
+      void initialize( unsigned workers ) ;
+
+      /** Method to retrieve the number of workers of this pool.
+       * @return The number of workers of this pool.
+       */
+      unsigned size() const ;
+
+      /** Method to queue a task for the next run of this pool.
+       * @param task The index of the task to queue.
+       */
+      void push( unsigned task ) ;
+
+      /** Method to run every queued task to completion.
+       * The calling thread participates as worker 0, so a pool of one worker never spawns a thread.
+       * @param job The function to call for every queued task.
+       */
+      void run( const Job& job ) ;
+
+      /** Method to run every queued task to completion under a watchdog.
+       * Every worker runs on its own detached thread while the calling thread watches the running tasks. A task that runs
+       * past its limit is expired, and its worker is left to finish on its own while a new worker takes its place.
+       * Once the deadline passes, every running task and every task still queued is expired.
+       * The job is copied and may still run on an abandoned worker after this returns, so it must own whatever it touches.
+       * @param job The function to call for every queued task.
+       * @param limit The function returning how long each task may run.
+       * @param expire The function called for every task that times out.
+       * @param deadline The time in milliseconds after which the run is stopped. Zero never stops it.
+       */
+      void run( const Job& job, const Limit& limit, const Expire& expire, double deadline ) ;
+    private:
+
+      /** Forward-declared structure to contain this object's internal data.
+       */
+      struct PoolData *pool_data ;
+
+      /** Method to retrieve a reference to this object's internal data.
+       * @return Reference to this object's internal data.
+       */
+      PoolData& data() ;
+
+      /** Method to retrieve a const reference to this object's internal data.
+       * @return Const-reference to this object's internal data.
+       */
+      const PoolData& data() const ;
+  };
+}
+
+#endif
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Record.h"
+#include "Sink.h"
+#include <fstream>
+#include <stdio.h>
+
+namespace athena
+{
+  /** The first line of every result file.
+   */
+  constexpr const char* RECORD_HEADER = "# athena results 1" ;
+
+  /** The amount of tab-separated fields following the name on each line.
+   */
+  constexpr unsigned RECORD_FIELDS = 12 ;
+
+  void formatRecord( std::string& lines, const std::string& name, const Record& record )
+  {
+    const Statistics& stats = record.statistics ;
+
+    format( lines, "%s\t%u\t%u\t%d\t%.17g\t%u\t%llu\t%.17g\t%.17g\t%.17g\t%.17g\t%.17g\t%.17g\n",
+            name.c_str(), record.result.value(), record.reason.value(), record.code, record.time,
+            stats.samples, static_cast<unsigned long long>( stats.iterations ),
+            stats.min, stats.median, stats.mean, stats.p90, stats.p99, stats.stddev ) ;
+  }
+
+  bool saveRecords( const char* path, const std::string& lines )
+  {
+    FILE* file ;
+
+    file = fopen( path, "w" ) ;
+    if( !file ) return false ;
+
+    fprintf( file, "%s\n", RECORD_HEADER ) ;
+    fwrite( lines.data(), 1, lines.size(), file ) ;
+
+    return fclose( file ) == 0 ;
+  }
+
+  bool loadRecords( const char* path, RecordMap& records )
+  {
+    std::ifstream      file       ;
+    std::string        line       ;
+    std::string        name       ;
+    Record             record     ;
+    size_t             split      ;
+    unsigned           result     ;
+    unsigned           reason     ;
+    unsigned long long iterations ;
+    int                read       ;
+
+    file.open( path ) ;
+    if( !file ) return false ;
+
+    if( !std::getline( file, line ) || line != RECORD_HEADER ) return false ;
+
+    while( std::getline( file, line ) )
+    {
+      // The name may hold tabs itself, so it is everything before the last RECORD_FIELDS fields.
+      split = line.size() ;
+      for( unsigned field = 0; field < RECORD_FIELDS && split != std::string::npos && split != 0; field++ )
+      {
+        split = line.rfind( '\t', split - 1 ) ;
+      }
+
+      if( split == std::string::npos || split == 0 ) continue ;
+
+      name   = line.substr( 0, split ) ;
+      record = Record() ;
+      read   = sscanf( line.c_str() + split + 1, "%u\t%u\t%d\t%lg\t%u\t%llu\t%lg\t%lg\t%lg\t%lg\t%lg\t%lg",
+                       &result, &reason, &record.code, &record.time, &record.statistics.samples, &iterations,
+                       &record.statistics.min, &record.statistics.median, &record.statistics.mean,
+                       &record.statistics.p90, &record.statistics.p99, &record.statistics.stddev ) ;
+
+      if( read != static_cast<int>( RECORD_FIELDS ) ) continue ;
+
+      record.result.set( result ) ;
+      record.reason.set( reason ) ;
+      record.statistics.iterations = iterations ;
+      records[ name ]              = record     ;
+    }
+
+    return true ;
+  }
+}
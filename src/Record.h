@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATHENA_RECORD_H
+#define ATHENA_RECORD_H
+
+#include "Manager.h"
+#include "Allocations.h"
+#include "Benchmark.h"
+#include "Counters.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace athena
+{
+  /** Structure to contain how a test did over its runs when it was repeated or retried.
+   */
+  struct Repetition
+  {
+    unsigned   runs    ; ///< The amount of times the test ran, retries included. Zero unless it was repeated or retried.
+    unsigned   passed  ; ///< The amount of those runs that passed.
+    unsigned   first   ; ///< The run the test first failed in, counting from one. Zero when no run failed.
+    unsigned   retries ; ///< The amount of runs that retried the test after every run before them failed.
+    Statistics times   ; ///< The distribution of the runs' times, in nanoseconds.
+  };
+
+  /** Structure to contain the outcome of a single test.
+   */
+  struct Record
+  {
+    Result     result     ; ///< The result of the test.
+    double     time       ; ///< The time the test took, in microseconds.
+    Reason     reason     ; ///< Why the test crashed or failed, if it did.
+    int        code       ; ///< The signal or exit code of a crashed test.
+    Statistics statistics ; ///< The timing statistics of a benchmark. Has no samples for tests.
+    Counters    counters    ; ///< The hardware counters of the test, per iteration. Counts no events unless counters are on.
+    Allocations allocations ; ///< The heap allocations of the test, or of one iteration of a benchmark.
+    Comparison  comparison  ; ///< How a benchmark variant compares to its benchmark's first variant. Has no speedup otherwise.
+    Throughput  throughput  ; ///< The work one iteration of a benchmark does. Counts nothing unless set with setThroughput.
+    Scaling     scaling     ; ///< How a benchmark's time grows with the size of its input. Has no sizes unless swept.
+    std::vector<Contention> contention ; ///< How a benchmark scales over threads, one entry per amount. Empty unless run on threads.
+    Repetition  repetition  ; ///< How the test did over its runs. Has no runs unless it was repeated or retried.
+    bool       compared   ; ///< Whether or not this test was compared to a baseline.
+    double     delta      ; ///< The relative change of this test's time against its baseline ( 0.1 is 10% slower ).
+    bool       regression ; ///< Whether or not this test was slower than its baseline by more than the threshold and noise.
+  };
+
+  /** Map of test names to their records, in name order.
+   */
+  typedef std::map<std::string, Record> RecordMap ;
+
+  /** Function to append the line a record is saved as in a result file.
+   * @param lines The lines to append to.
+   * @param name The name of the test.
+   * @param record The record of the test.
+   */
+  void formatRecord( std::string& lines, const std::string& name, const Record& record ) ;
+
+  /** Function to save lines appended with formatRecord to a text result file.
+   * @param path The path of the file to write.
+   * @param lines The lines to save.
+   * @return Whether or not the file was written.
+   */
+  bool saveRecords( const char* path, const std::string& lines ) ;
+
+  /** Function to load the records of a result file, adding them to a map. Tests already in the map are overwritten.
+   * @param path The path of the file to read.
+   * @param records The map to add the file's records to.
+   * @return Whether or not the file was read.
+   */
+  bool loadRecords( const char* path, RecordMap& records ) ;
+}
+
+#endif
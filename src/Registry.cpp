@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Registry.h"
+#include "Manager.h"
+#include <algorithm>
+#include <memory>
+#include <string.h>
+#include <vector>
+
+namespace athena
+{
+  /** The size of each block of an arena. Anything larger gets a block of its own.
+   */
+  constexpr std::size_t BLOCK_SIZE = 16 * 1024 ;
+
+  static_assert( CALLABLE_PASS == Result::Pass, "A callable returning nothing must pass." ) ;
+
+  /** Structure to contain a single registered test.
+   */
+  struct Entry
+  {
+    const char* name      ;
+    Callable*   callable  ;
+    bool        benchmark ;
+    unsigned    cases     ;
+  };
+
+  struct ArenaData
+  {
+    std::vector<std::unique_ptr<unsigned char[]>> blocks ;
+    unsigned char*                                next   ;
+    std::size_t                                   left   ;
+
+    /** Default constructor.
+     */
+    ArenaData() ;
+  };
+
+  struct RegistryData
+  {
+    Arena                         arena   ;
+    std::vector<Entry>            entries ;
+    mutable std::vector<unsigned> order   ;
+    mutable bool                  sorted  ;
+
+    /** Default constructor.
+     */
+    RegistryData() ;
+
+    /** Method to sort the entries by name, dropping every name registered more than once but the first.
+     * Only sorts when an entry was added since the last sort.
+     */
+    void sort() const ;
+  };
+
+  ArenaData::ArenaData()
+  {
+    this->next = nullptr ;
+    this->left = 0       ;
+  }
+
+  RegistryData::RegistryData()
+  {
+    this->sorted = true ;
+  }
+
+  void RegistryData::sort() const
+  {
+    auto before = [this]( unsigned first, unsigned second ) { return strcmp( this->entries[ first ].name, this->entries[ second ].name ) <  0 ; } ;
+    auto same   = [this]( unsigned first, unsigned second ) { return strcmp( this->entries[ first ].name, this->entries[ second ].name ) == 0 ; } ;
+
+    if( this->sorted ) return ;
+
+    this->order.resize( this->entries.size() ) ;
+    for( unsigned index = 0; index < this->order.size(); index++ ) this->order[ index ] = index ;
+
+    std::stable_sort( this->order.begin(), this->order.end(), before ) ;
+    this->order.erase( std::unique( this->order.begin(), this->order.end(), same ), this->order.end() ) ;
+    this->sorted = true ;
+  }
+
+  Arena::Arena()
+  {
+    this->arena_data = new ArenaData() ;
+  }
+
+  Arena::~Arena()
+  {
+    delete this->arena_data ;
+  }
+
+  void* Arena::allocate( std::size_t size, std::size_t alignment )
+  {
+    std::size_t    padding ;
+    std::size_t    block   ;
+    unsigned char* memory  ;
+
+    padding = ( alignment - reinterpret_cast<std::uintptr_t>( data().next ) % alignment ) % alignment ;
+
+    if( data().next == nullptr || padding + size > data().left )
+    {
+      block = std::max( BLOCK_SIZE, size + alignment ) ;
+      data().blocks.emplace_back( new unsigned char[ block ] ) ;
+      data().next = data().blocks.back().get()                                                   ;
+      data().left = block                                                                        ;
+      padding     = ( alignment - reinterpret_cast<std::uintptr_t>( data().next ) % alignment ) % alignment ;
+    }
+
+    memory       = data().next + padding ;
+    data().next += padding + size        ;
+    data().left -= padding + size        ;
+
+    return memory ;
+  }
+
+  const char* Arena::copy( const char* text )
+  {
+    const std::size_t size   = strlen( text ) + 1                                  ;
+    char*             memory = static_cast<char*>( this->allocate( size, 1 ) ) ;
+
+    memcpy( memory, text, size ) ;
+    return memory ;
+  }
+
+  ArenaData& Arena::data()
+  {
+    return *this->arena_data ;
+  }
+
+  const ArenaData& Arena::data() const
+  {
+    return *this->arena_data ;
+  }
+
+  Callable::~Callable()
+  {
+    this->table->destroy( this->object ) ;
+  }
+
+  unsigned Callable::test( std::size_t item )
+  {
+    return this->table->test( this->object, item ) ;
+  }
+
+  void Callable::run( std::uint64_t iterations )
+  {
+    this->table->run( this->object, iterations ) ;
+  }
+
+  bool Callable::asynchronous() const
+  {
+    return this->table->asynchronous ;
+  }
+
+  bool Callable::start( std::size_t item, Coroutine& coroutine )
+  {
+    return this->table->start( this->object, item, coroutine ) ;
+  }
+
+  Registry::Registry()
+  {
+    this->registry_data = new RegistryData() ;
+  }
+
+  Registry::~Registry()
+  {
+    // The arena only releases memory, so every callable is destroyed first.
+    for( auto& entry : data().entries )
+    {
+      entry.callable->~Callable() ;
+    }
+
+    delete this->registry_data ;
+  }
+
+  unsigned Registry::size() const
+  {
+    data().sort() ;
+    return data().order.size() ;
+  }
+
+  const char* Registry::name( unsigned index ) const
+  {
+    data().sort() ;
+    return data().entries[ data().order[ index ] ].name ;
+  }
+
+  Callable* Registry::callable( unsigned index ) const
+  {
+    data().sort() ;
+    return data().entries[ data().order[ index ] ].callable ;
+  }
+
+  bool Registry::benchmark( unsigned index ) const
+  {
+    data().sort() ;
+    return data().entries[ data().order[ index ] ].benchmark ;
+  }
+
+  unsigned Registry::cases( unsigned index ) const
+  {
+    data().sort() ;
+    return data().entries[ data().order[ index ] ].cases ;
+  }
+
+  unsigned Registry::find( const char* name ) const
+  {
+    std::vector<unsigned>::const_iterator found ;
+
+    data().sort() ;
+    found = std::lower_bound( data().order.begin(), data().order.end(), name, [this]( unsigned index, const char* key )
+    {
+      return strcmp( data().entries[ index ].name, key ) < 0 ;
+    } ) ;
+
+    if( found == data().order.end() || strcmp( data().entries[ *found ].name, name ) != 0 ) return data().order.size() ;
+    return found - data().order.begin() ;
+  }
+
+  void Registry::range( const char* prefix, unsigned& first, unsigned& last ) const
+  {
+    const std::size_t                     length = strlen( prefix ) ;
+    std::vector<unsigned>::const_iterator lower  ;
+    std::vector<unsigned>::const_iterator upper  ;
+
+    data().sort() ;
+
+    // Names sharing a prefix are contiguous in name order, so the sorted index acts as a flattened trie.
+    lower = std::lower_bound( data().order.cbegin(), data().order.cend(), prefix, [this, length]( unsigned index, const char* key )
+    {
+      return strncmp( data().entries[ index ].name, key, length ) < 0 ;
+    } ) ;
+    upper = std::upper_bound( lower, data().order.cend(), prefix, [this, length]( const char* key, unsigned index )
+    {
+      return strncmp( key, data().entries[ index ].name, length ) < 0 ;
+    } ) ;
+
+    first = lower - data().order.cbegin() ;
+    last  = upper - data().order.cbegin() ;
+  }
+
+  void Registry::add( const Descriptor* begin, const Descriptor* end )
+  {
+    void* memory ;
+
+    if( begin == nullptr || begin == end ) return ;
+
+    data().entries.reserve( data().entries.size() + ( end - begin ) ) ;
+    for( const Descriptor* descriptor = begin; descriptor != end; descriptor++ )
+    {
+      memory = data().arena.allocate( sizeof( Callable ), alignof( Callable ) ) ;
+      this->insert( descriptor->name, new ( memory ) Callable( descriptor->function, data().arena ), descriptor->benchmark, 0 ) ;
+    }
+  }
+
+  void Registry::insert( const char* name, Callable* callable, bool benchmark, unsigned cases )
+  {
+    data().entries.push_back( { name, callable, benchmark, cases } ) ;
+    data().sorted = false ;
+  }
+
+  Arena& Registry::arena()
+  {
+    return data().arena ;
+  }
+
+  RegistryData& Registry::data()
+  {
+    return *this->registry_data ;
+  }
+
+  const RegistryData& Registry::data() const
+  {
+    return *this->registry_data ;
+  }
+}
@@ -0,0 +1,528 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATHENA_REGISTRY_H
+#define ATHENA_REGISTRY_H
+
+#include "Benchmark.h"
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace athena
+{
+  class Result ;
+
+  /** Trait naming Result through a template parameter, so templates only need it complete once they are instantiated.
+   */
+  template<typename TYPE>
+  struct Outcome
+  {
+    typedef Result type ;
+  };
+
+  /** The value of Result::Pass, reported by every callable that returns nothing or something that isn't a result.
+   */
+  constexpr unsigned CALLABLE_PASS = 1 ;
+
+  /** Structure to contain a started coroutine test, erased down to its frame and the functions driving it.
+   * Lets the library, built without coroutine support, run the coroutines of programs built with it.
+   */
+  struct Coroutine
+  {
+    void*    frame                       ; ///< The address of the coroutine's frame.
+    void     ( *resume  )( void* frame ) ; ///< Resumes the coroutine until it next suspends or finishes.
+    void     ( *destroy )( void* frame ) ; ///< Destroys the coroutine's frame, wherever it is suspended.
+    bool     ( *done    )( void* frame ) ; ///< Whether the coroutine has finished.
+    unsigned ( *result  )( void* frame ) ; ///< The value of the result the coroutine finished with.
+  };
+
+  /** Trait marking the types returned by coroutine tests, which are run on an executor instead of being called.
+   * Specializations provide a static start function, turning a returned value into a Coroutine.
+   */
+  template<typename TYPE>
+  struct Asynchronous : std::false_type
+  {
+  };
+
+  /** Trait naming the type a callable returns, whether it takes no arguments or the index of a case.
+   */
+  template<typename TYPE, bool NULLARY = std::is_invocable<TYPE&>::value>
+  struct Returned
+  {
+    typedef std::invoke_result_t<TYPE&> type ;
+  };
+
+  template<typename TYPE>
+  struct Returned<TYPE, false>
+  {
+    typedef std::invoke_result_t<TYPE&, std::size_t> type ;
+  };
+
+  /** The size of the buffer a callable is stored in without any further allocation.
+   */
+  constexpr std::size_t CALLABLE_STORAGE = 32 ;
+
+  /** Class to hand out memory from large blocks, all released at once when it is destroyed.
+   */
+  class Arena
+  {
+    public:
+
+      /** Default constructor.
+       */
+      Arena() ;
+
+      /** Default deconstructor. Releases every block, without destroying what was built in them.
+       */
+      ~Arena() ;
+
+      /** Method to allocate memory that lives as long as this object.
+       * @param size The amount of bytes to allocate.
+       * @param alignment The alignment of the memory.
+       * @return Pointer to the allocated memory.
+       */
+      void* allocate( std::size_t size, std::size_t alignment ) ;
+
+      /** Method to copy a string into this object's memory.
+       * @param text The string to copy.
+       * @return Pointer to the null-terminated copy.
+       */
+      const char* copy( const char* text ) ;
+    private:
+
+      /** Forward-declared structure to contain this object's internal data.
+       */
+      struct ArenaData *arena_data ;
+
+      /** Method to retrieve a reference to this object's internal data.
+       * @return Reference to this object's internal data.
+       */
+      ArenaData& data() ;
+
+      /** Method to retrieve a const reference to this object's internal data.
+       * @return Const-reference to this object's internal data.
+       */
+      const ArenaData& data() const ;
+  };
+
+  /** Class to type-erase anything callable with no arguments: functions, lambdas, capturing functors or bound methods.
+   * The cases of a parameterized test are a single callable taking the index of the case instead. Callables that fit in CALLABLE_STORAGE are stored inline, larger ones in the arena they are built with.
+   * A callable never moves once built, so a test still running on an abandoned thread keeps a valid object.
+   */
+  class Callable
+  {
+    public:
+
+      /** Constructor.
+       * @param callable The callable to store.
+       * @param arena The arena to store the callable in when it doesn't fit inline.
+       */
+      template<typename CALLABLE>
+      Callable( CALLABLE&& callable, Arena& arena ) ;
+
+      /** Deconstructor. Destroys the stored callable.
+       */
+      ~Callable() ;
+
+      Callable( const Callable& ) = delete ;
+
+      Callable& operator=( const Callable& ) = delete ;
+
+      /** Method to call the stored callable once as a test.
+       * @param item The index of the case to test. Ignored by callables taking no arguments.
+       * @return The value of the test's result. Callables returning nothing, or something that isn't a result, always pass.
+       */
+      unsigned test( std::size_t item = 0 ) ;
+
+      /** Method to call the stored callable in a tight loop, keeping its return value from being optimized away.
+       * @param iterations The amount of times to call it.
+       */
+      void run( std::uint64_t iterations ) ;
+
+      /** Method to retrieve whether the stored callable is a coroutine test.
+       * @return Whether or not calling it returns a coroutine to run on an executor.
+       */
+      bool asynchronous() const ;
+
+      /** Method to call a stored coroutine test, leaving it suspended before its first statement.
+       * @param item The index of the case to start. Ignored by callables taking no arguments.
+       * @param coroutine Reference to the coroutine to fill out. The caller takes ownership of its frame.
+       * @return Whether the callable is a coroutine test, and was started.
+       */
+      bool start( std::size_t item, Coroutine& coroutine ) ;
+    private:
+
+      /** Structure to contain the functions operating on one type of stored callable.
+       */
+      struct Operations
+      {
+        unsigned ( *test    )( void* object, std::size_t item                         ) ;
+        void     ( *run     )( void* object, std::uint64_t iterations                 ) ;
+        void     ( *destroy )( void* object                                           ) ;
+        bool     ( *start   )( void* object, std::size_t item, Coroutine& coroutine ) ;
+        bool     asynchronous                                                           ;
+      };
+
+      /** Function to call a stored callable as a test.
+       * @param object The stored callable.
+       * @param item The index of the case to test.
+       * @return The value of the test's result.
+       */
+      template<typename TYPE>
+      static unsigned invoke( void* object, std::size_t item ) ;
+
+      /** Function to interpret what a callable returns as a test's result.
+       * @param callable The callable, taking no arguments.
+       * @return The value of the test's result.
+       */
+      template<typename TYPE>
+      static unsigned evaluate( TYPE& callable ) ;
+
+      /** Function to call a stored callable in a tight loop.
+       * @param object The stored callable.
+       * @param iterations The amount of times to call it.
+       */
+      template<typename TYPE>
+      static void loop( void* object, std::uint64_t iterations ) ;
+
+      /** Function to destroy a stored callable.
+       * @param object The stored callable.
+       */
+      template<typename TYPE>
+      static void destroy( void* object ) ;
+
+      /** Function to start a stored coroutine test.
+       * @param object The stored callable.
+       * @param item The index of the case to start.
+       * @param coroutine Reference to the coroutine to fill out.
+       * @return Whether the callable is a coroutine test.
+       */
+      template<typename TYPE>
+      static bool launch( void* object, std::size_t item, Coroutine& coroutine ) ;
+
+      /** The table of functions operating on each type of stored callable.
+       */
+      template<typename TYPE>
+      static constexpr Operations operations = { &Callable::invoke<TYPE>, &Callable::loop<TYPE>, &Callable::destroy<TYPE>, &Callable::launch<TYPE>,
+                                                 Asynchronous<typename Returned<TYPE>::type>::value } ;
+
+      alignas( std::max_align_t ) unsigned char storage[ CALLABLE_STORAGE ] ;
+      const Operations*                         table                       ;
+      void*                                     object                      ;
+  };
+
+  /** Structure to describe a test registered with ATHENA_TEST or ATHENA_BENCHMARK.
+   * Descriptors are constant-initialized, so registering a test runs no code before main.
+   */
+  struct Descriptor
+  {
+    const char* name          ; ///< The name of the test.
+    Result      ( *function )() ; ///< The function of the test.
+    bool        benchmark     ; ///< Whether the test is measured as a benchmark.
+  };
+
+  /** Class to store every test of a manager contiguously, without allocating for each one.
+   * Names and callables live in an arena, so they keep their address for as long as the registry lives.
+   */
+  class Registry
+  {
+    public:
+
+      /** Default constructor.
+       */
+      Registry() ;
+
+      /** Default deconstructor. Destroys every callable.
+       */
+      ~Registry() ;
+
+      /** Method to add a callable under a name. A name that is already registered keeps its first callable.
+       * @param name The name of the test.
+       * @param callable The callable to test.
+       * @param benchmark Whether the callable is measured as a benchmark instead of tested.
+       * @param cases The amount of cases of a parameterized test, whose callable takes the index of a case. Zero for a plain test.
+       */
+      template<typename CALLABLE>
+      void add( const char* name, CALLABLE&& callable, bool benchmark, unsigned cases = 0 ) ;
+
+      /** Method to add every test described by an array of descriptors. Their names are used in place, without a copy.
+       * @param begin The first descriptor.
+       * @param end One past the last descriptor.
+       */
+      void add( const Descriptor* begin, const Descriptor* end ) ;
+
+      /** Method to retrieve the amount of distinct tests registered.
+       * @return The amount of tests.
+       */
+      unsigned size() const ;
+
+      /** Method to retrieve the name of a test.
+       * @param index The index of the test, in name order.
+       * @return The name of the test.
+       */
+      const char* name( unsigned index ) const ;
+
+      /** Method to retrieve the callable of a test.
+       * @param index The index of the test, in name order.
+       * @return The callable of the test.
+       */
+      Callable* callable( unsigned index ) const ;
+
+      /** Method to retrieve whether a test is a benchmark.
+       * @param index The index of the test, in name order.
+       * @return Whether or not the test is a benchmark.
+       */
+      bool benchmark( unsigned index ) const ;
+
+      /** Method to retrieve the amount of cases of a test.
+       * @param index The index of the test, in name order.
+       * @return The amount of cases of a parameterized test, or zero for a plain test.
+       */
+      unsigned cases( unsigned index ) const ;
+
+      /** Method to find the index of a test by name.
+       * @param name The name of the test.
+       * @return The index of the test in name order, or size() when it isn't registered.
+       */
+      unsigned find( const char* name ) const ;
+
+      /** Method to find the range of tests whose name starts with a prefix. Takes a binary search, however many tests there are.
+       * @param prefix The prefix of the names.
+       * @param first Reference to the index of the first test with the prefix, in name order.
+       * @param last Reference to one past the index of the last test with the prefix.
+       */
+      void range( const char* prefix, unsigned& first, unsigned& last ) const ;
+    private:
+
+      /** Method to record an entry built in this object's arena.
+       * @param name The name of the entry, which must outlive this object.
+       * @param callable The callable of the entry, built in the arena.
+       * @param benchmark Whether the entry is a benchmark.
+       * @param cases The amount of cases of the entry, zero for a plain test.
+       */
+      void insert( const char* name, Callable* callable, bool benchmark, unsigned cases ) ;
+
+      /** Method to retrieve this object's arena.
+       * @return Reference to this object's arena.
+       */
+      Arena& arena() ;
+
+      /** Forward-declared structure to contain this object's internal data.
+       */
+      struct RegistryData *registry_data ;
+
+      /** Method to retrieve a reference to this object's internal data.
+       * @return Reference to this object's internal data.
+       */
+      RegistryData& data() ;
+
+      /** Method to retrieve a const reference to this object's internal data.
+       * @return Const-reference to this object's internal data.
+       */
+      const RegistryData& data() const ;
+  };
+
+  template<typename CALLABLE>
+  Callable::Callable( CALLABLE&& callable, Arena& arena )
+  {
+    typedef typename std::decay<CALLABLE>::type TYPE ;
+
+    if constexpr( sizeof( TYPE ) <= CALLABLE_STORAGE && alignof( TYPE ) <= alignof( std::max_align_t ) )
+    {
+      this->object = this->storage ;
+    }
+    else
+    {
+      this->object = arena.allocate( sizeof( TYPE ), alignof( TYPE ) ) ;
+    }
+
+    new ( this->object ) TYPE( std::forward<CALLABLE>( callable ) ) ;
+    this->table = &Callable::operations<TYPE> ;
+  }
+
+  template<typename TYPE>
+  unsigned Callable::invoke( void* object, std::size_t item )
+  {
+    TYPE& callable = *static_cast<TYPE*>( object ) ;
+
+    if constexpr( std::is_invocable<TYPE&>::value )
+    {
+      return Callable::evaluate( callable ) ;
+    }
+    else
+    {
+      auto bound = [&callable, item]() { return callable( item ) ; } ;
+      return Callable::evaluate( bound ) ;
+    }
+  }
+
+  template<typename TYPE>
+  unsigned Callable::evaluate( TYPE& callable )
+  {
+    typedef typename Outcome<TYPE>::type RESULT ;
+
+    // Benchmarks may return anything, so only values that make a result are interpreted.
+    if constexpr( std::is_constructible<RESULT, decltype( callable() )>::value )
+    {
+      return static_cast<RESULT>( callable() ).value() ;
+    }
+    else
+    {
+      callable() ;
+      return CALLABLE_PASS ;
+    }
+  }
+
+  template<typename TYPE>
+  void Callable::loop( void* object, std::uint64_t iterations )
+  {
+    TYPE& callable = *static_cast<TYPE*>( object ) ;
+
+    for( std::uint64_t iteration = 0; iteration < iterations; iteration++ )
+    {
+      // Parameterized tests are only ever tested, but are measured one case after another all the same.
+      if constexpr( !std::is_invocable<TYPE&>::value )
+      {
+        doNotOptimize( Callable::invoke<TYPE>( object, iteration ) ) ;
+      }
+      else if constexpr( std::is_void<decltype( callable() )>::value )
+      {
+        callable() ;
+        clobberMemory() ;
+      }
+      else
+      {
+        doNotOptimize( callable() ) ;
+      }
+    }
+  }
+
+  template<typename TYPE>
+  void Callable::destroy( void* object )
+  {
+    static_cast<TYPE*>( object )->~TYPE() ;
+  }
+
+  template<typename TYPE>
+  bool Callable::launch( void* object, std::size_t item, Coroutine& coroutine )
+  {
+    typedef typename Returned<TYPE>::type RETURNED ;
+
+    TYPE& callable = *static_cast<TYPE*>( object ) ;
+
+    if constexpr( !Asynchronous<RETURNED>::value )
+    {
+      static_cast<void>( callable  ) ;
+      static_cast<void>( item      ) ;
+      static_cast<void>( coroutine ) ;
+      return false ;
+    }
+    else if constexpr( std::is_invocable<TYPE&>::value )
+    {
+      static_cast<void>( item ) ;
+      coroutine = Asynchronous<RETURNED>::start( callable() ) ;
+      return true ;
+    }
+    else
+    {
+      coroutine = Asynchronous<RETURNED>::start( callable( item ) ) ;
+      return true ;
+    }
+  }
+
+  template<typename CALLABLE>
+  void Registry::add( const char* name, CALLABLE&& callable, bool benchmark, unsigned cases )
+  {
+    void*     memory  ;
+    Callable* created ;
+
+    memory  = this->arena().allocate( sizeof( Callable ), alignof( Callable ) ) ;
+    created = new ( memory ) Callable( std::forward<CALLABLE>( callable ), this->arena() ) ;
+
+    this->insert( this->arena().copy( name ), created, benchmark, cases ) ;
+  }
+}
+
+/* Tests registered with ATHENA_TEST are collected into one table by the linker. On ELF platforms each descriptor is put in the
+ * athena_tests section, whose bounds the linker provides as __start_athena_tests and __stop_athena_tests. The bounds are hidden,
+ * so every executable or shared library only sees its own tests. Elsewhere descriptors are chained into a list instead, which
+ * costs a static constructor per test but still never allocates.
+ */
+#if defined( __ELF__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define ATHENA_SECTION_TABLE
+#define ATHENA_LOCAL __attribute__( ( visibility( "hidden" ) ) )
+
+extern "C"
+{
+  extern const athena::Descriptor __start_athena_tests[] __attribute__( ( weak, visibility( "hidden" ) ) ) ;
+  extern const athena::Descriptor __stop_athena_tests [] __attribute__( ( weak, visibility( "hidden" ) ) ) ;
+}
+
+#define ATHENA_REGISTER( NAME, BENCHMARK )                                                                                        \
+  static athena::Result athena_test_##NAME() ;                                                                                    \
+  __attribute__( ( used, section( "athena_tests" ) ) )                                                                           \
+  static const athena::Descriptor athena_descriptor_##NAME = { #NAME, &athena_test_##NAME, BENCHMARK } ;                         \
+  static athena::Result athena_test_##NAME()
+#else
+namespace athena
+{
+  /** Structure to chain the descriptors of a module together where no linker section is available.
+   */
+  struct Link
+  {
+    Descriptor descriptor ;
+    Link*      next       ;
+
+    /** Constructor. Adds this link to the front of the module's list.
+     * @param descriptor The descriptor of the test.
+     */
+    Link( const Descriptor& descriptor ) ;
+  };
+
+  /** The first link of the list of tests registered with ATHENA_TEST.
+   */
+  inline Link* links = nullptr ;
+
+  inline Link::Link( const Descriptor& descriptor )
+  {
+    this->descriptor = descriptor ;
+    this->next       = links      ;
+    links            = this       ;
+  }
+}
+
+#define ATHENA_LOCAL
+
+#define ATHENA_REGISTER( NAME, BENCHMARK )                                                                                        \
+  static athena::Result athena_test_##NAME() ;                                                                                    \
+  static athena::Link athena_link_##NAME( { #NAME, &athena_test_##NAME, BENCHMARK } ) ;                                           \
+  static athena::Result athena_test_##NAME()
+#endif
+
+/** Macro to define and register a test, which every Manager of the module runs without a call to add.
+ * The body follows the macro and returns a Result or a bool, e.g. ATHENA_TEST( addition ) { return 1 + 1 == 2 ; }
+ */
+#define ATHENA_TEST( NAME ) ATHENA_REGISTER( NAME, false )
+
+/** Macro to define and register a benchmark, which every Manager of the module measures without a call to benchmark.
+ */
+#define ATHENA_BENCHMARK( NAME ) ATHENA_REGISTER( NAME, true )
+
+#endif
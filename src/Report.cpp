@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Manager.h"
+#include <iostream>
+#include <string.h>
+
+/** Tool to merge the result files or journals of several runs ( e.g. the shards of one suite ) into a single report.
+ * Usage: athena_report [--quiet|--verbose] [--format <formats>] <result file>...
+ * Exits with 1 if any merged test failed, and 2 if a file couldn't be read.
+ */
+int main( int argc, char** argv )
+{
+  athena::Manager manager ;
+  athena::Output  output  ;
+  unsigned        files   ;
+
+  files = 0 ;
+  manager.initialize( "Merged Results" ) ;
+
+  for( int index = 1; index < argc; index++ )
+  {
+    if     ( strcmp( argv[ index ], "--quiet"   ) == 0 ) output = athena::Output::Quiet   ;
+    else if( strcmp( argv[ index ], "--verbose" ) == 0 ) output = athena::Output::Verbose ;
+    else if( strcmp( argv[ index ], "--format"  ) == 0 )
+    {
+      if( index + 1 >= argc || !manager.setFormat( argv[ ++index ] ) )
+      {
+        std::cerr << "athena_report: Unable to report in format " << ( index < argc ? argv[ index ] : "" ) << "\n" ;
+        return 2 ;
+      }
+    }
+    else if( manager.load( argv[ index ] )                ) files++                          ;
+    else
+    {
+      std::cerr << "athena_report: Unable to read result file " << argv[ index ] << "\n" ;
+      return 2 ;
+    }
+  }
+
+  if( files == 0 )
+  {
+    std::cerr << "Usage: athena_report [--quiet|--verbose] [--format <formats>] <result file>...\n" ;
+    return 2 ;
+  }
+
+  return manager.report( output ) == 0 ? 0 : 1 ;
+}
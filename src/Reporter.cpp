@@ -0,0 +1,779 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Reporter.h"
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+namespace athena
+{
+#if defined ( __unix__ ) || defined( _WIN32 )
+  constexpr const char* END_COLOR    = "\x1B[m"     ;
+  constexpr const char* COLOR_GREEN  = "\u001b[32m" ;
+  constexpr const char* COLOR_GREY   = "\x1B[1;30m" ;
+  constexpr const char* COLOR_RED    = "\u001b[31m" ;
+  constexpr const char* COLOR_WHITE  = "\u001b[1m"  ;
+  constexpr const char* COLOR_YELLOW = "\u001b[33m" ;
+#else
+  constexpr const char* END_COLOR    = "" ;
+  constexpr const char* COLOR_GREEN  = "" ;
+  constexpr const char* COLOR_GREY   = "" ;
+  constexpr const char* COLOR_RED    = "" ;
+  constexpr const char* COLOR_WHITE  = "" ;
+  constexpr const char* COLOR_YELLOW = "" ;
+#endif
+
+  /** The line framing the console's header and summary.
+   */
+  constexpr const char* RULE = "------------------------------------------------------------" ;
+
+  /** Function to obtain a color from a test result.
+   * @param result The result to retrieve a color for.
+   * @return A color representing the result.
+   */
+  static const char* colorFromResult( Result result )
+  {
+    switch( result.value() )
+    {
+      case Result::Pass :
+        return COLOR_GREEN ;
+      case Result::Fail :
+        return COLOR_RED ;
+      case Result::Skip   :
+      case Result::NotRun :
+        return COLOR_GREY ;
+      case Result::Flaky :
+        return COLOR_YELLOW ;
+      default:
+        return COLOR_RED ;
+    };
+  }
+
+  /** Function to format a time with the most readable unit.
+   * @param nanoseconds The time to format, in nanoseconds.
+   * @return The formatted time.
+   */
+  static std::string formatTime( double nanoseconds )
+  {
+    char buffer[ 32 ] ;
+    
+    if     ( nanoseconds < 1e3 ) snprintf( buffer, sizeof( buffer ), "%.2fns", nanoseconds       ) ;
+    else if( nanoseconds < 1e6 ) snprintf( buffer, sizeof( buffer ), "%.2fμs", nanoseconds / 1e3 ) ;
+    else if( nanoseconds < 1e9 ) snprintf( buffer, sizeof( buffer ), "%.2fms", nanoseconds / 1e6 ) ;
+    else                         snprintf( buffer, sizeof( buffer ), "%.2fs" , nanoseconds / 1e9 ) ;
+    
+    return std::string( buffer ) ;
+  }
+
+  /** Function to format a rate with the most readable decimal prefix.
+   * @param rate The amount done per second.
+   * @param unit The unit of the amount, following the prefix.
+   * @return The formatted rate per second.
+   */
+  static std::string formatRate( double rate, const char* unit )
+  {
+    char buffer[ 48 ] ;
+    
+    if     ( rate < 1e3 ) snprintf( buffer, sizeof( buffer ), "%.2f%s/s" , rate       , unit ) ;
+    else if( rate < 1e6 ) snprintf( buffer, sizeof( buffer ), "%.2fk%s/s", rate / 1e3 , unit ) ;
+    else if( rate < 1e9 ) snprintf( buffer, sizeof( buffer ), "%.2fM%s/s", rate / 1e6 , unit ) ;
+    else                  snprintf( buffer, sizeof( buffer ), "%.2fG%s/s", rate / 1e9 , unit ) ;
+    
+    return std::string( buffer ) ;
+  }
+
+  /** Structure to name a hardware counter in every format.
+   */
+  struct CounterName
+  {
+    unsigned          event ; ///< The flag of the counter's event.
+    const char*       text  ; ///< The name printed to the console.
+    const char*       key   ; ///< The name used by machine-readable formats.
+    double Counters::*count ; ///< The count of the event.
+  };
+
+  /** The name of every hardware counter, in the order they are reported.
+   */
+  static const CounterName COUNTER_NAMES[] =
+  {
+    { Counters::Cycles      , "cycles"       , "cycles"       , &Counters::cycles        },
+    { Counters::Instructions, "instructions" , "instructions" , &Counters::instructions  },
+    { Counters::BranchMisses, "branch misses", "branch_misses", &Counters::branch_misses },
+    { Counters::L1Misses    , "L1 misses"    , "l1_misses"    , &Counters::l1_misses     },
+    { Counters::LLCMisses   , "LLC misses"   , "llc_misses"   , &Counters::llc_misses    },
+  };
+
+  /** Function to describe why a test crashed or stopped, if it did.
+   * @param record The record of the test.
+   * @return The description, empty when the test has no reason.
+   */
+  static std::string describe( const Record& record )
+  {
+    std::string text ;
+    
+    switch( record.reason.value() )
+    {
+      case Reason::Signal :
+#ifdef __unix__
+        format( text, "Signal %d ( %s )", record.code, strsignal( record.code ) ) ;
+#else
+        format( text, "Signal %d", record.code ) ;
+#endif
+        break ;
+      case Reason::Exit :
+        format( text, "Exit code %d", record.code ) ;
+        break ;
+      case Reason::Deadline :
+        text = "Stopped by the run's deadline" ;
+        break ;
+      case Reason::Regression :
+        format( text, "%+.1f%% slower than baseline", record.delta * 100.0 ) ;
+        break ;
+      case Reason::Budget :
+        format( text, "Over its allocation budget with %llu allocations and %llu bytes at peak",
+                static_cast<unsigned long long>( record.allocations.count ), static_cast<unsigned long long>( record.allocations.peak ) ) ;
+        break ;
+      case Reason::Complexity :
+        format( text, "Grows as %s, faster than expected", Complexity( record.scaling.complexity ).name() ) ;
+        break ;
+      default :
+        break ;
+    };
+    
+    // A flaky test's reason is that of its first failed run.
+    if( record.result.value() == Result::Flaky )
+    {
+      std::string runs ;
+      
+      format( runs, "Failed %u of %u runs, first in run %u", record.repetition.runs - record.repetition.passed, record.repetition.runs, record.repetition.first ) ;
+      text = text.empty() ? runs : runs + ": " + text ;
+    }
+    
+    return text ;
+  }
+
+  /** Function to append text to a buffer, escaped to be used in XML.
+   * @param buffer The buffer to append to.
+   * @param text The text to escape.
+   */
+  static void escapeXml( std::string& buffer, const char* text )
+  {
+    for( ; *text != '\0'; text++ )
+    {
+      switch( *text )
+      {
+        case '&'  : buffer += "&amp;"  ; break ;
+        case '<'  : buffer += "&lt;"   ; break ;
+        case '>'  : buffer += "&gt;"   ; break ;
+        case '"'  : buffer += "&quot;" ; break ;
+        case '\'' : buffer += "&apos;" ; break ;
+        default   : buffer += *text    ; break ;
+      };
+    }
+  }
+
+  /** Function to append text to a buffer as a quoted JSON string.
+   * @param buffer The buffer to append to.
+   * @param text The text to quote.
+   */
+  static void quoteJson( std::string& buffer, const char* text )
+  {
+    buffer += '"' ;
+    for( ; *text != '\0'; text++ )
+    {
+      switch( *text )
+      {
+        case '"'  : buffer += "\\\"" ; break ;
+        case '\\' : buffer += "\\\\" ; break ;
+        case '\n' : buffer += "\\n"  ; break ;
+        case '\t' : buffer += "\\t"  ; break ;
+        default   :
+          if( static_cast<unsigned char>( *text ) < 0x20 ) format( buffer, "\\u%04x", static_cast<unsigned>( *text ) ) ;
+          else                                             buffer += *text ;
+          break ;
+      };
+    }
+    buffer += '"' ;
+  }
+
+  struct ConsoleData
+  {
+    Sink     sink    ;
+    Output   output  ;
+    unsigned count   ;
+    unsigned printed ;
+
+    /** Default constructor.
+     */
+    ConsoleData() ;
+  };
+
+  ConsoleData::ConsoleData()
+  {
+    this->output  = Output::Normal ;
+    this->count   = 0              ;
+    this->printed = 0              ;
+  }
+
+  /** Structure to contain the totals of a JUnit test suite.
+   */
+  struct Totals
+  {
+    unsigned tests    ;
+    unsigned failures ;
+    unsigned errors   ;
+    unsigned skipped  ;
+    double   time     ;
+  };
+
+  struct JUnitData
+  {
+    Sink        sink    ;
+    std::string path    ;
+    std::string program ;
+    std::string cases   ;
+    std::string suites  ;
+    Totals      suite   ;
+    Totals      total   ;
+
+    /** Default constructor.
+     */
+    JUnitData() ;
+  };
+
+  JUnitData::JUnitData()
+  {
+    this->suite = Totals() ;
+    this->total = Totals() ;
+  }
+
+  struct JsonLinesData
+  {
+    Sink        sink ;
+    std::string line ;
+  };
+
+  Console::Console()
+  {
+    this->console_data = new ConsoleData() ;
+  }
+
+  Console::Console( const Output& output )
+  {
+    this->console_data = new ConsoleData() ;
+    this->setOutput( output ) ;
+  }
+
+  Console::~Console()
+  {
+    delete this->console_data ;
+  }
+
+  bool Console::initialize( const char* path )
+  {
+    return data().sink.initialize( path ) ;
+  }
+
+  void Console::setOutput( const Output& output )
+  {
+    data().output = output ;
+  }
+
+  void Console::begin( const char* program, unsigned count )
+  {
+    const std::size_t length = strlen( program ) ;
+
+    data().count   = count ;
+    data().printed = 0     ;
+
+    data().sink.print( "\n%s%s\n", COLOR_WHITE, RULE ) ;
+    data().sink.print( "%s ATHENA: %s%s%*s|\n", COLOR_WHITE, program, COLOR_WHITE, static_cast<int>( length < 50 ? 50 - length : 0 ), "" ) ;
+    data().sink.print( "%s%s\n%s", COLOR_WHITE, RULE, END_COLOR ) ;
+    data().sink.commit() ;
+  }
+
+  void Console::start( const char* )
+  {
+  }
+
+  void Console::finish( const char* name, const Record& test )
+  {
+    const Output      output = data().output                    ;
+    const bool        last   = ++data().printed == data().count ;
+    const Result      result = test.result                      ;
+    const double      time   = test.time                        ;
+    const std::string reason = describe( test )                 ;
+    Sink&             sink   = data().sink                      ;
+    
+    if( output.value() == Output::Quiet ) return ;
+    
+    sink.print( "%s--|%s%s ", colorFromResult( result ), result.symbol(), result.name() ) ;
+
+    if( output.value() == Output::Verbose && test.statistics.samples != 0 )
+    {
+      sink.print( "%8s", formatTime( test.statistics.median ).c_str() ) ;
+    }
+    else if( output.value() == Output::Verbose && result.value() != Result::Skip && result.value() != Result::NotRun )
+    {
+      if( time < 1000.0 ) sink.print( "%06.2fμs", time          ) ;
+      else                sink.print( "%06.2fms", time / 1000.0 ) ;
+    }
+    else if( result.value() == Result::Skip || result.value() == Result::NotRun )
+    {
+      sink.write( "NONE    " ) ;
+    }
+    
+    sink.print( " %s %s ", last ? "└─" : "├─", name ) ;
+    
+    if( output.value() == Output::Verbose && test.statistics.samples != 0 )
+    {
+      sink.print( "[ min %s | mean %s | p90 %s | p99 %s | stddev %s | %u x %llu ] ",
+                  formatTime( test.statistics.min    ).c_str(), formatTime( test.statistics.mean   ).c_str(),
+                  formatTime( test.statistics.p90    ).c_str(), formatTime( test.statistics.p99    ).c_str(),
+                  formatTime( test.statistics.stddev ).c_str(), test.statistics.samples, 
+                  static_cast<unsigned long long>( test.statistics.iterations ) ) ;
+    }
+    
+    if( output.value() == Output::Verbose && test.statistics.median > 0.0 && ( test.throughput.items != 0 || test.throughput.bytes != 0 ) )
+    {
+      sink.write( "(" ) ;
+      if( test.throughput.items != 0                               ) sink.print( " %s", formatRate( test.throughput.items * 1e9 / test.statistics.median, " items" ).c_str() ) ;
+      if( test.throughput.items != 0 && test.throughput.bytes != 0 ) sink.write( " |" ) ;
+      if( test.throughput.bytes != 0                               ) sink.print( " %s", formatRate( test.throughput.bytes * 1e9 / test.statistics.median, "B"      ).c_str() ) ;
+      sink.write( " ) " ) ;
+    }
+    
+    if( output.value() == Output::Verbose && !test.contention.empty() )
+    {
+      sink.write( "(" ) ;
+      for( const Contention& level : test.contention )
+      {
+        sink.print( "%s %u %s %s, %s each", &level == &test.contention.front() ? "" : " |", level.threads, level.threads == 1 ? "thread" : "threads",
+                    formatRate( level.throughput, "" ).c_str(), formatRate( level.throughput / level.threads, "" ).c_str() ) ;
+        
+        // The slowest and fastest thread show whether some threads were starved while others ran freely.
+        if( level.rates.size() > 1 )
+        {
+          sink.print( " ( %s - %s )", formatRate( *std::min_element( level.rates.begin(), level.rates.end() ), "" ).c_str(),
+                      formatRate( *std::max_element( level.rates.begin(), level.rates.end() ), "" ).c_str() ) ;
+        }
+        
+        sink.print( ", %.0f%% efficient, p99 %s", level.efficiency * 100.0, formatTime( level.statistics.p99 ).c_str() ) ;
+      }
+      sink.write( " ) " ) ;
+    }
+    
+    if( output.value() == Output::Verbose && test.repetition.runs != 0 )
+    {
+      sink.print( "( %u / %u runs passed", test.repetition.passed, test.repetition.runs ) ;
+      if( test.repetition.retries != 0 ) sink.print( ", %u %s", test.repetition.retries, test.repetition.retries == 1 ? "retry" : "retries" ) ;
+      sink.print( " | min %s | median %s | p90 %s ) ", formatTime( test.repetition.times.min ).c_str(), formatTime( test.repetition.times.median ).c_str(),
+                  formatTime( test.repetition.times.p90 ).c_str() ) ;
+    }
+    
+    if( output.value() == Output::Verbose && test.scaling.sizes != 0 )
+    {
+      sink.print( "( %s | coefficient %s | rms %.1f%% over %u sizes ) ", Complexity( test.scaling.complexity ).name(),
+                  formatTime( test.scaling.coefficient ).c_str(), test.scaling.rms * 100.0, test.scaling.sizes ) ;
+    }
+    
+    if( output.value() == Output::Verbose && test.counters.events != 0 )
+    {
+      sink.print( "{ IPC %.2f ", instructionsPerCycle( test.counters ) ) ;
+      for( const auto& counter : COUNTER_NAMES )
+      {
+        if( test.counters.events & counter.event ) sink.print( "| %s %.1f ", counter.text, test.counters.*counter.count ) ;
+      }
+      sink.write( "} " ) ;
+    }
+    
+    if( output.value() == Output::Verbose && test.allocations.tracked )
+    {
+      sink.print( "< %llu allocations | %llu bytes | peak %llu bytes > ", static_cast<unsigned long long>( test.allocations.count ),
+                  static_cast<unsigned long long>( test.allocations.bytes ), static_cast<unsigned long long>( test.allocations.peak ) ) ;
+    }
+    
+    if( !reason.empty() && test.reason.value() != Reason::Regression )
+    {
+      sink.print( "-> %s ", reason.c_str() ) ;
+    }
+    
+    if( test.compared )
+    {
+      sink.print( "( %+.1f%% vs baseline%s", test.delta * 100.0, test.regression ? ", REGRESSION ) " : " ) " ) ;
+    }
+    
+    if( test.comparison.speedup > 0.0 && !test.comparison.conclusive )
+    {
+      sink.print( "( inconclusive: %.2fx, 95%% CI %.2fx - %.2fx ) ", test.comparison.speedup, test.comparison.lower, test.comparison.upper ) ;
+    }
+    else if( test.comparison.speedup >= 1.0 )
+    {
+      sink.print( "( %.2fx faster, 95%% CI %.2fx - %.2fx ) ", test.comparison.speedup, test.comparison.lower, test.comparison.upper ) ;
+    }
+    else if( test.comparison.speedup > 0.0 )
+    {
+      sink.print( "( %.2fx slower, 95%% CI %.2fx - %.2fx ) ", 1.0 / test.comparison.speedup, 1.0 / test.comparison.upper, 1.0 / test.comparison.lower ) ;
+    }
+    
+    sink.write( END_COLOR ) ;
+    if( !last ) sink.write( "\n" ) ;
+    sink.commit() ;
+  }
+  
+  void Console::end( const Summary& summary )
+  {
+    const unsigned total = summary.passed + summary.failed + summary.flaky         ;
+    const char*    color = summary.passed == total ? COLOR_GREEN : COLOR_RED      ;
+    Sink&          sink  = data().sink                                            ;
+    
+    sink.write( "\n\n" ) ;
+    sink.print( "%s  Test Results: %s\n"             , color, END_COLOR                            ) ;
+    sink.print( "%s     ├─Passed : %u / %u%s\n"      , color, summary.passed , total, END_COLOR    ) ;
+    sink.print( "%s     ├─Failed : %u / %u%s\n"      , color, summary.failed , total, END_COLOR    ) ;
+    
+    if( summary.flaky != 0 )
+    {
+      sink.print( "%s     ├─Flaky  : %u / %u%s\n", color, summary.flaky, total, END_COLOR ) ;
+    }
+    
+    sink.print( "%s     %sSkipped: %u%s\n"           , color, summary.compared || summary.notrun != 0 ? "├─" : "└─", summary.skipped, END_COLOR ) ;
+    
+    if( summary.notrun != 0 )
+    {
+      sink.print( "%s     %sNot run: %u%s\n", color, summary.compared ? "├─" : "└─", summary.notrun, END_COLOR ) ;
+    }
+    
+    if( summary.compared )
+    {
+      sink.print( "%s     └─Regressed: %u%s\n", color, summary.regressed, END_COLOR ) ;
+    }
+    
+    if( data().output.value() == Output::Verbose )
+    {
+      if( summary.time >= 1000.0 ) sink.print( "%s\n  Total Elapsed Time : %.5fms%s\n", COLOR_WHITE, summary.time / 1000.0, END_COLOR ) ;
+      else                         sink.print( "%s\n  Total Elapsed Time : %.5fμs%s\n", COLOR_WHITE, summary.time         , END_COLOR ) ;
+      
+      if( summary.makespan > 0.0 )
+      {
+        sink.print( "%s  Makespan           : %.5fms ( ideal %.5fms, %.1f%% efficient )%s\n", COLOR_WHITE, summary.makespan / 1000.0, summary.ideal / 1000.0,
+                    100.0 * summary.ideal / summary.makespan, END_COLOR ) ;
+      }
+    }
+    
+    sink.print( "%s%s%s\n\n", COLOR_WHITE, RULE, END_COLOR ) ;
+    sink.flush() ;
+  }
+
+  ConsoleData& Console::data()
+  {
+    return *this->console_data ;
+  }
+
+  const ConsoleData& Console::data() const
+  {
+    return *this->console_data ;
+  }
+
+  JUnit::JUnit()
+  {
+    this->junit_data = new JUnitData() ;
+  }
+
+  JUnit::~JUnit()
+  {
+    delete this->junit_data ;
+  }
+
+  bool JUnit::initialize( const char* path )
+  {
+    data().path  = path != nullptr ? path : "" ;
+    data().total = Totals()                    ;
+    data().suites.clear() ;
+    
+    return data().sink.initialize( path ) ;
+  }
+
+  void JUnit::begin( const char* program, unsigned )
+  {
+    data().program = program  ;
+    data().suite   = Totals() ;
+    data().cases.clear() ;
+  }
+
+  void JUnit::start( const char* )
+  {
+  }
+
+  void JUnit::finish( const char* name, const Record& record )
+  {
+    std::string& cases = data().cases ;
+    std::string  text  = describe( record ) ;
+    
+    data().suite.tests++ ;
+    
+    cases += "    <testcase name=\"" ;
+    escapeXml( cases, name ) ;
+    cases += "\" classname=\"" ;
+    escapeXml( cases, data().program.c_str() ) ;
+    format( cases, "\" time=\"%.6f\"", record.time / 1e6 ) ;
+    
+    if( record.counters.events != 0 || record.allocations.tracked || record.repetition.runs != 0 )
+    {
+      cases += "><properties" ;
+      
+      if( record.counters.events != 0 )
+      {
+        format( cases, "><property name=\"ipc\" value=\"%.4f\"/", instructionsPerCycle( record.counters ) ) ;
+        for( const auto& counter : COUNTER_NAMES )
+        {
+          if( record.counters.events & counter.event ) format( cases, "><property name=\"%s\" value=\"%.3f\"/", counter.key, record.counters.*counter.count ) ;
+        }
+      }
+      
+      if( record.allocations.tracked )
+      {
+        format( cases, "><property name=\"allocations\" value=\"%llu\"/><property name=\"allocated_bytes\" value=\"%llu\"/><property name=\"peak_bytes\" value=\"%llu\"/",
+                static_cast<unsigned long long>( record.allocations.count ), static_cast<unsigned long long>( record.allocations.bytes ),
+                static_cast<unsigned long long>( record.allocations.peak ) ) ;
+      }
+      
+      if( record.repetition.runs != 0 )
+      {
+        format( cases, "><property name=\"runs\" value=\"%u\"/><property name=\"passed_runs\" value=\"%u\"/><property name=\"first_failed_run\" value=\"%u\"/><property name=\"retries\" value=\"%u\"/",
+                record.repetition.runs, record.repetition.passed, record.repetition.first, record.repetition.retries ) ;
+      }
+      
+      cases += "></properties" ;
+      
+      if( record.result.value() == Result::Pass )
+      {
+        cases += "></testcase>\n" ;
+        return ;
+      }
+    }
+    
+    switch( record.result.value() )
+    {
+      case Result::Pass :
+        cases += "/>\n" ;
+        return ;
+      case Result::Skip :
+        data().suite.skipped++ ;
+        cases += "><skipped/></testcase>\n" ;
+        return ;
+      case Result::NotRun :
+        data().suite.skipped++ ;
+        cases += "><skipped message=\"Not run\"/></testcase>\n" ;
+        return ;
+      case Result::Crash :
+        data().suite.errors++ ;
+        cases += "><error type=\"Crash\" message=\"" ;
+        break ;
+      case Result::Flaky :
+        cases += "><flakyFailure type=\"Flaky\" message=\"" ;
+        break ;
+      default :
+        data().suite.failures++ ;
+        format( cases, "><failure type=\"%s\" message=\"", record.result.name() ) ;
+        break ;
+    };
+    
+    escapeXml( cases, text.empty() ? record.result.name() : text.c_str() ) ;
+    cases += "\"/></testcase>\n" ;
+  }
+
+  void JUnit::end( const Summary& summary )
+  {
+    Sink&   sink  = data().sink  ;
+    Totals& suite = data().suite ;
+    Totals& total = data().total ;
+    
+    suite.time = summary.time / 1e6 ;
+    
+    // A file holds every run reported to it as one suite each, so it is rewritten whole with the new totals.
+    if( data().path.empty() )
+    {
+      data().suites.clear() ;
+      total = Totals() ;
+    }
+    
+    data().suites += "  <testsuite name=\"" ;
+    escapeXml( data().suites, data().program.c_str() ) ;
+    format( data().suites, "\" tests=\"%u\" failures=\"%u\" errors=\"%u\" skipped=\"%u\" time=\"%.6f\">\n", suite.tests, suite.failures, suite.errors, suite.skipped, suite.time ) ;
+    data().suites += data().cases ;
+    data().suites += "  </testsuite>\n" ;
+    data().cases.clear() ;
+    
+    total.tests    += suite.tests    ;
+    total.failures += suite.failures ;
+    total.errors   += suite.errors   ;
+    total.skipped  += suite.skipped  ;
+    total.time     += suite.time     ;
+    
+    if( !data().path.empty() ) sink.initialize( data().path.c_str() ) ;
+    
+    sink.write( "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n" ) ;
+    sink.print( "<testsuites tests=\"%u\" failures=\"%u\" errors=\"%u\" skipped=\"%u\" time=\"%.6f\">\n", total.tests, total.failures, total.errors, total.skipped, total.time ) ;
+    sink.write( data().suites.data(), data().suites.size() ) ;
+    sink.write( "</testsuites>\n" ) ;
+    sink.flush() ;
+  }
+
+  JUnitData& JUnit::data()
+  {
+    return *this->junit_data ;
+  }
+
+  const JUnitData& JUnit::data() const
+  {
+    return *this->junit_data ;
+  }
+
+  JsonLines::JsonLines()
+  {
+    this->json_lines_data = new JsonLinesData() ;
+  }
+
+  JsonLines::~JsonLines()
+  {
+    delete this->json_lines_data ;
+  }
+
+  bool JsonLines::initialize( const char* path )
+  {
+    return data().sink.initialize( path ) ;
+  }
+
+  void JsonLines::begin( const char* program, unsigned count )
+  {
+    std::string& line = data().line ;
+    
+    line = "{\"event\":\"begin\",\"program\":" ;
+    quoteJson( line, program ) ;
+    format( line, ",\"count\":%u}\n", count ) ;
+    
+    data().sink.write( line.data(), line.size() ) ;
+    data().sink.commit() ;
+  }
+
+  void JsonLines::start( const char* )
+  {
+  }
+
+  void JsonLines::finish( const char* name, const Record& record )
+  {
+    const Statistics& statistics = record.statistics ;
+    std::string&      line       = data().line       ;
+    
+    line = "{\"event\":\"finish\",\"name\":" ;
+    quoteJson( line, name ) ;
+    format( line, ",\"result\":\"%s\",\"reason\":\"%s\",\"code\":%d,\"time_us\":%.3f", record.result.name(), record.reason.name(), record.code, record.time ) ;
+    
+    if( statistics.samples != 0 )
+    {
+      format( line, ",\"statistics\":{\"min_ns\":%.3f,\"median_ns\":%.3f,\"mean_ns\":%.3f,\"p90_ns\":%.3f,\"p99_ns\":%.3f,\"stddev_ns\":%.3f,\"overhead_ns\":%.3f,\"samples\":%u,\"iterations\":%llu}",
+              statistics.min, statistics.median, statistics.mean, statistics.p90, statistics.p99, statistics.stddev, statistics.overhead, statistics.samples,
+              static_cast<unsigned long long>( statistics.iterations ) ) ;
+    }
+    
+    if( record.comparison.speedup > 0.0 )
+    {
+      format( line, ",\"comparison\":{\"speedup\":%.4f,\"lower\":%.4f,\"upper\":%.4f,\"conclusive\":%s}", record.comparison.speedup,
+              record.comparison.lower, record.comparison.upper, record.comparison.conclusive ? "true" : "false" ) ;
+    }
+    
+    if( statistics.median > 0.0 && ( record.throughput.items != 0 || record.throughput.bytes != 0 ) )
+    {
+      format( line, ",\"throughput\":{\"items\":%llu,\"bytes\":%llu,\"items_per_second\":%.3f,\"bytes_per_second\":%.3f}",
+              static_cast<unsigned long long>( record.throughput.items ), static_cast<unsigned long long>( record.throughput.bytes ),
+              record.throughput.items * 1e9 / statistics.median, record.throughput.bytes * 1e9 / statistics.median ) ;
+    }
+    
+    if( !record.contention.empty() )
+    {
+      line += ",\"contention\":[" ;
+      for( const Contention& level : record.contention )
+      {
+        format( line, "%s{\"threads\":%u,\"throughput\":%.3f,\"per_thread\":%.3f,\"efficiency\":%.4f,\"median_ns\":%.3f,\"p99_ns\":%.3f,\"samples\":%u,\"rates\":[",
+                &level == &record.contention.front() ? "" : ",", level.threads, level.throughput, level.throughput / level.threads,
+                level.efficiency, level.statistics.median, level.statistics.p99, level.statistics.samples ) ;
+        for( const double& rate : level.rates ) format( line, "%s%.3f", &rate == &level.rates.front() ? "" : ",", rate ) ;
+        line += "]}" ;
+      }
+      line += "]" ;
+    }
+    
+    if( record.repetition.runs != 0 )
+    {
+      format( line, ",\"repetition\":{\"runs\":%u,\"passed\":%u,\"first_failed_run\":%u,\"retries\":%u,\"min_ns\":%.3f,\"median_ns\":%.3f,\"mean_ns\":%.3f,\"p90_ns\":%.3f,\"stddev_ns\":%.3f}",
+              record.repetition.runs, record.repetition.passed, record.repetition.first, record.repetition.retries, record.repetition.times.min,
+              record.repetition.times.median, record.repetition.times.mean, record.repetition.times.p90, record.repetition.times.stddev ) ;
+    }
+    
+    if( record.scaling.sizes != 0 )
+    {
+      format( line, ",\"scaling\":{\"complexity\":\"%s\",\"coefficient_ns\":%.6f,\"rms\":%.4f,\"sizes\":%u}",
+              Complexity( record.scaling.complexity ).name(), record.scaling.coefficient, record.scaling.rms, record.scaling.sizes ) ;
+    }
+    
+    if( record.counters.events != 0 )
+    {
+      format( line, ",\"counters\":{\"ipc\":%.4f", instructionsPerCycle( record.counters ) ) ;
+      for( const auto& counter : COUNTER_NAMES )
+      {
+        if( record.counters.events & counter.event ) format( line, ",\"%s\":%.3f", counter.key, record.counters.*counter.count ) ;
+      }
+      line += '}' ;
+    }
+    
+    if( record.allocations.tracked )
+    {
+      format( line, ",\"allocations\":{\"count\":%llu,\"bytes\":%llu,\"peak_bytes\":%llu}", static_cast<unsigned long long>( record.allocations.count ),
+              static_cast<unsigned long long>( record.allocations.bytes ), static_cast<unsigned long long>( record.allocations.peak ) ) ;
+    }
+    
+    if( record.compared )
+    {
+      format( line, ",\"delta\":%.6f,\"regression\":%s", record.delta, record.regression ? "true" : "false" ) ;
+    }
+    
+    line += "}\n" ;
+    
+    data().sink.write( line.data(), line.size() ) ;
+    data().sink.commit() ;
+  }
+
+  void JsonLines::end( const Summary& summary )
+  {
+    data().sink.print( "{\"event\":\"end\",\"passed\":%u,\"failed\":%u,\"flaky\":%u,\"skipped\":%u,\"not_run\":%u,\"regressed\":%u,\"time_us\":%.3f,\"makespan_us\":%.3f,\"ideal_us\":%.3f}\n",
+                       summary.passed, summary.failed, summary.flaky, summary.skipped, summary.notrun, summary.regressed, summary.time, summary.makespan, summary.ideal ) ;
+    data().sink.flush() ;
+  }
+
+  JsonLinesData& JsonLines::data()
+  {
+    return *this->json_lines_data ;
+  }
+
+  const JsonLinesData& JsonLines::data() const
+  {
+    return *this->json_lines_data ;
+  }
+}
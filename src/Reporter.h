@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATHENA_REPORTER_H
+#define ATHENA_REPORTER_H
+
+#include "Manager.h"
+#include "Record.h"
+#include "Sink.h"
+
+namespace athena
+{
+  /** Structure to contain the running totals of a test run.
+   */
+  struct Summary
+  {
+    unsigned passed    ; ///< The amount of passed tests.
+    unsigned failed    ; ///< The amount of failed, crashed and timed out tests.
+    unsigned skipped   ; ///< The amount of skipped tests.
+    unsigned notrun    ; ///< The amount of tests that never started because the run stopped after too many failures.
+    unsigned flaky     ; ///< The amount of tests that passed some of their runs and failed others.
+    unsigned regressed ; ///< The amount of tests slower than their baseline.
+    bool     compared  ; ///< Whether or not the run was compared against a baseline.
+    double   time      ; ///< The total time of every reported test, in microseconds.
+    double   makespan  ; ///< The wall time the parallel tests took from the first start to the last finish, in microseconds. Zero when none ran.
+    double   ideal     ; ///< The shortest makespan the parallel tests' times allow on the run's workers, in microseconds.
+  };
+
+  /** Interface for objects recieving the events of a test run as they happen.
+   * A manager never calls its reporters concurrently, even when tests run in parallel.
+   */
+  class Reporter
+  {
+    public:
+
+      /** Default deconstructor.
+       */
+      virtual ~Reporter() = default ;
+
+      /** Method called once before any test starts.
+       * @param program The name of the program being tested.
+       * @param count The amount of tests that will be reported.
+       */
+      virtual void begin( const char* program, unsigned count ) = 0 ;
+
+      /** Method called when a test starts running. Parallel tests start in any order.
+       * @param name The name of the test.
+       */
+      virtual void start( const char* name ) = 0 ;
+
+      /** Method called as soon as a test's record is ready to report.
+       * Records are reported in the same order whether tests run serially or in parallel.
+       * @param name The name of the test.
+       * @param record The outcome of the test.
+       */
+      virtual void finish( const char* name, const Record& record ) = 0 ;
+
+      /** Method called once every test has been reported.
+       * @param summary The totals of the run.
+       */
+      virtual void end( const Summary& summary ) = 0 ;
+  };
+
+  /** Reporter printing a colored tree of results, one line per test as it finishes.
+   */
+  class Console : public Reporter
+  {
+    public:
+
+      /** Default constructor. Reports to the standard output with Output::Normal.
+       */
+      Console() ;
+
+      /** Constructor.
+       * @param output The desired way to output tests.
+       */
+      Console( const Output& output ) ;
+
+      /** Default deconstructor.
+       */
+      ~Console() ;
+
+      /** Method to set where this reporter prints its tree.
+       * @param path The path of the file to write. Null writes to the standard output.
+       * @return Whether or not the file could be opened.
+       */
+      bool initialize( const char* path ) ;
+
+      /** Method to set how this reporter outputs tests.
+       * @param output The desired way to output tests.
+       */
+      void setOutput( const Output& output ) ;
+
+      void begin( const char* program, unsigned count ) override ;
+
+      void start( const char* name ) override ;
+
+      void finish( const char* name, const Record& record ) override ;
+
+      void end( const Summary& summary ) override ;
+    private:
+
+      /** Forward-declared structure to contain this object's internal data.
+       */
+      struct ConsoleData *console_data ;
+
+      /** Method to retrieve a reference to this object's internal data.
+       * @return Reference to this object's internal data.
+       */
+      ConsoleData& data() ;
+
+      /** Method to retrieve a const reference to this object's internal data.
+       * @return Const-reference to this object's internal data.
+       */
+      const ConsoleData& data() const ;
+  };
+
+  /** Reporter writing a JUnit XML report, as read by most CI dashboards.
+   * The report's totals come before its test cases, so it is written once the run ends. A file holds one suite for every
+   * run reported to it and is rewritten at the end of each, while the standard output gets a whole report per run.
+   */
+  class JUnit : public Reporter
+  {
+    public:
+
+      /** Default constructor. Reports to the standard output.
+       */
+      JUnit() ;
+
+      /** Default deconstructor.
+       */
+      ~JUnit() ;
+
+      /** Method to set where this reporter writes its report.
+       * @param path The path of the file to write. Null writes to the standard output.
+       * @return Whether or not the file could be opened.
+       */
+      bool initialize( const char* path ) ;
+
+      void begin( const char* program, unsigned count ) override ;
+
+      void start( const char* name ) override ;
+
+      void finish( const char* name, const Record& record ) override ;
+
+      void end( const Summary& summary ) override ;
+    private:
+
+      /** Forward-declared structure to contain this object's internal data.
+       */
+      struct JUnitData *junit_data ;
+
+      /** Method to retrieve a reference to this object's internal data.
+       * @return Reference to this object's internal data.
+       */
+      JUnitData& data() ;
+
+      /** Method to retrieve a const reference to this object's internal data.
+       * @return Const-reference to this object's internal data.
+       */
+      const JUnitData& data() const ;
+  };
+
+  /** Reporter writing one JSON object per line: one per finished test, then one with the run's totals.
+   */
+  class JsonLines : public Reporter
+  {
+    public:
+
+      /** Default constructor. Reports to the standard output.
+       */
+      JsonLines() ;
+
+      /** Default deconstructor.
+       */
+      ~JsonLines() ;
+
+      /** Method to set where this reporter writes its lines.
+       * @param path The path of the file to write. Null writes to the standard output.
+       * @return Whether or not the file could be opened.
+       */
+      bool initialize( const char* path ) ;
+
+      void begin( const char* program, unsigned count ) override ;
+
+      void start( const char* name ) override ;
+
+      void finish( const char* name, const Record& record ) override ;
+
+      void end( const Summary& summary ) override ;
+    private:
+
+      /** Forward-declared structure to contain this object's internal data.
+       */
+      struct JsonLinesData *json_lines_data ;
+
+      /** Method to retrieve a reference to this object's internal data.
+       * @return Reference to this object's internal data.
+       */
+      JsonLinesData& data() ;
+
+      /** Method to retrieve a const reference to this object's internal data.
+       * @return Const-reference to this object's internal data.
+       */
+      const JsonLinesData& data() const ;
+  };
+}
+
+#endif
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Sink.h"
+#include <chrono>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __unix__
+#include <unistd.h>
+#endif
+
+namespace athena
+{
+  /** The amount of buffered bytes after which a commit writes the buffer out.
+   */
+  constexpr std::size_t CHUNK_SIZE = 64 * 1024 ;
+
+  /** The longest a commit to a pipe waits before it's written out, in milliseconds.
+   */
+  constexpr double FLUSH_INTERVAL = 100.0 ;
+
+  /** Function to append printf-style formatted text to a string, from a variadic argument list.
+   * @param buffer The string to append to.
+   * @param format The printf format of the text.
+   * @param arguments The arguments of the format.
+   */
+  static void formatList( std::string& buffer, const char* format, va_list arguments )
+  {
+    std::size_t offset ;
+    va_list     copy   ;
+    int         amount ;
+
+    // Most lines fit in a few hundred bytes, so they're formatted in place with a single pass.
+    offset = buffer.size() ;
+    buffer.resize( offset + 256 ) ;
+
+    va_copy( copy, arguments ) ;
+    amount = vsnprintf( &buffer[ offset ], buffer.size() - offset, format, copy ) ;
+    va_end( copy ) ;
+
+    if( amount < 0 )
+    {
+      buffer.resize( offset ) ;
+      return ;
+    }
+
+    if( offset + amount >= buffer.size() )
+    {
+      buffer.resize( offset + amount + 1 ) ;
+      vsnprintf( &buffer[ offset ], amount + 1, format, arguments ) ;
+    }
+
+    buffer.resize( offset + amount ) ;
+  }
+
+  void format( std::string& buffer, const char* format, ... )
+  {
+    va_list arguments ;
+
+    va_start( arguments, format ) ;
+    formatList( buffer, format, arguments ) ;
+    va_end( arguments ) ;
+  }
+
+  struct SinkData
+  {
+    std::string                           buffer      ;
+    FILE*                                 file        ;
+    std::chrono::steady_clock::time_point flushed     ; ///< When the buffer was last written out.
+    bool                                  owned       ;
+    bool                                  interactive ; ///< Whether the file is a terminal, so every commit is written out right away.
+
+    /** Default constructor.
+     */
+    SinkData() ;
+
+    /** Method to close the current file, if this object opened it.
+     */
+    void close() ;
+  };
+
+  SinkData::SinkData()
+  {
+    this->file        = stdout                           ;
+    this->flushed     = std::chrono::steady_clock::now() ;
+    this->owned       = false                            ;
+    this->interactive = false                            ;
+    this->buffer.reserve( CHUNK_SIZE ) ;
+  }
+
+  void SinkData::close()
+  {
+    if( this->owned ) fclose( this->file ) ;
+
+    this->file  = stdout ;
+    this->owned = false  ;
+  }
+
+  Sink::Sink()
+  {
+    this->sink_data = new SinkData() ;
+    this->initialize( nullptr ) ;
+  }
+
+  Sink::~Sink()
+  {
+    this->flush() ;
+    data().close() ;
+    delete this->sink_data ;
+  }
+
+  bool Sink::initialize( const char* path )
+  {
+    FILE* file ;
+
+    this->flush() ;
+    data().close() ;
+
+    if( path != nullptr && strcmp( path, "-" ) != 0 )
+    {
+      file = fopen( path, "w" ) ;
+      if( file == nullptr ) return false ;
+
+      data().file  = file ;
+      data().owned = true ;
+    }
+
+#ifdef __unix__
+    data().interactive = isatty( fileno( data().file ) ) != 0 ;
+#endif
+
+    return true ;
+  }
+
+  void Sink::write( const char* text, std::size_t size )
+  {
+    data().buffer.append( text, size ) ;
+  }
+
+  void Sink::write( const char* text )
+  {
+    data().buffer.append( text ) ;
+  }
+
+  void Sink::print( const char* format, ... )
+  {
+    va_list arguments ;
+
+    va_start( arguments, format ) ;
+    formatList( data().buffer, format, arguments ) ;
+    va_end( arguments ) ;
+  }
+
+  void Sink::commit()
+  {
+    bool due ;
+
+    // The standard output piped somewhere, as on CI, is still watched as the run goes, so the first commit after
+    // FLUSH_INTERVAL writes it out, without paying a write for every commit. Only files wait for a full chunk.
+    due = data().file == stdout && std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - data().flushed ).count() >= FLUSH_INTERVAL ;
+
+    if( data().interactive || due || data().buffer.size() >= CHUNK_SIZE ) this->flush() ;
+  }
+
+  void Sink::flush()
+  {
+    if( data().buffer.empty() ) return ;
+
+    // Anything printed through the standard streams goes first, so output keeps the order it was produced in.
+    if( data().file == stdout ) fflush( stdout ) ;
+
+    fwrite( data().buffer.data(), 1, data().buffer.size(), data().file ) ;
+    fflush( data().file ) ;
+    data().buffer.clear() ;
+    data().flushed = std::chrono::steady_clock::now() ;
+  }
+
+  SinkData& Sink::data()
+  {
+    return *this->sink_data ;
+  }
+
+  const SinkData& Sink::data() const
+  {
+    return *this->sink_data ;
+  }
+}
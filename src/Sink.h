@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ATHENA_SINK_H
+#define ATHENA_SINK_H
+
+#include <cstddef>
+#include <string>
+
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define ATHENA_PRINTF( FORMAT, ARGUMENTS ) __attribute__( ( format( printf, FORMAT, ARGUMENTS ) ) )
+#else
+#define ATHENA_PRINTF( FORMAT, ARGUMENTS )
+#endif
+
+namespace athena
+{
+  /** Function to append printf-style formatted text to a string.
+   * @param buffer The string to append to.
+   * @param format The printf format of the text.
+   */
+  void format( std::string& buffer, const char* format, ... ) ATHENA_PRINTF( 2, 3 ) ;
+
+  /** Class to write text to a file or the standard output through a reusable buffer.
+   * Text is formatted straight into the buffer, which is written out in large chunks. When writing to a terminal every
+   * commit is written immediately instead, and a piped standard output is written every tenth of a second or so, so
+   * results still show up as they happen.
+   */
+  class Sink
+  {
+    public:
+
+      /** Default constructor. Writes to the standard output.
+       */
+      Sink() ;
+
+      /** Default deconstructor. Writes out anything still buffered.
+       */
+      ~Sink() ;
+
+      /** Method to initialize this sink with the file to write to, replacing the previous one.
+       * @param path The path of the file to write. Null or "-" writes to the standard output.
+       * @return Whether or not the file could be opened.
+       */
+      bool initialize( const char* path ) ;
+
+      /** Method to append text to this sink's buffer.
+       * @param text The text to append.
+       * @param size The amount of characters to append.
+       */
+      void write( const char* text, std::size_t size ) ;
+
+      /** Method to append a null-terminated string to this sink's buffer.
+       * @param text The text to append.
+       */
+      void write( const char* text ) ;
+
+      /** Method to append printf-style formatted text to this sink's buffer.
+       * @param format The printf format of the text.
+       */
+      void print( const char* format, ... ) ATHENA_PRINTF( 2, 3 ) ;
+
+      /** Method to mark the end of a unit of output, writing the buffer out if it is large enough, a terminal is being written
+       * to, or the standard output wasn't written to for a while.
+       */
+      void commit() ;
+
+      /** Method to write out everything buffered.
+       */
+      void flush() ;
+    private:
+
+      /** Forward-declared structure to contain this object's internal data.
+       */
+      struct SinkData *sink_data ;
+
+      /** Method to retrieve a reference to this object's internal data.
+       * @return Reference to this object's internal data.
+       */
+      SinkData& data() ;
+
+      /** Method to retrieve a const reference to this object's internal data.
+       * @return Const-reference to this object's internal data.
+       */
+      const SinkData& data() const ;
+  };
+}
+
+#endif
@@ -16,8 +16,47 @@
  */
 
 #include "Manager.h"
+#include "Reporter.h"
 #include <assert.h>
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
 #include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#ifdef __unix__
+#include <sys/wait.h>
+#endif
+
+class Counter : public athena::Reporter
+{
+  public:
+    unsigned                        begun      = 0   ;
+    unsigned                        started    = 0   ;
+    unsigned                        finished   = 0   ;
+    unsigned                        failed     = 0   ;
+    unsigned                        notrun     = 0   ;
+    unsigned                        flaky      = 0   ;
+    unsigned                        runs       = 0   ;
+    athena::Statistics              statistics = {}  ;
+    std::vector<athena::Contention> contention       ;
+    double                          makespan   = 0.0 ;
+    std::string                     first            ;
+    std::string                     last             ;
+    
+    void begin( const char*, unsigned ) override { this->begun++ ; this->first.clear() ; }
+    
+    void start( const char* name ) override { this->started++ ; if( this->first.empty() ) this->first = name ; }
+    
+    void finish( const char* name, const athena::Record& record ) override { this->finished++ ; this->last = name ; this->runs = record.repetition.runs ; this->statistics = record.statistics ; this->contention = record.contention ; }
+    
+    void end( const athena::Summary& summary ) override { this->failed = summary.failed ; this->notrun = summary.notrun ; this->flaky = summary.flaky ; this->makespan = summary.makespan ; }
+};
 
 class Object
 {
@@ -50,6 +89,21 @@ bool Object::method3()
   return false ;
 }
 
+struct Dataset
+{
+  static std::atomic<unsigned> built     ;
+  static std::atomic<unsigned> destroyed ;
+  
+  unsigned values[ 3 ] = { 1, 2, 3 } ;
+  
+  Dataset() { built++ ; }
+  
+  ~Dataset() { destroyed++ ; }
+};
+
+std::atomic<unsigned> Dataset::built     ( 0 ) ;
+std::atomic<unsigned> Dataset::destroyed ( 0 ) ;
+
 bool success()
 {
   std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) ) ;
@@ -62,6 +116,29 @@ bool failure()
   return false ;
 }
 
+unsigned sum()
+{
+  unsigned value = 0 ;
+  for( unsigned index = 0; index < 64; index++ ) value += index * index ;
+  return value ;
+}
+
+bool hang()
+{
+  std::this_thread::sleep_for( std::chrono::milliseconds( 250 ) ) ;
+  return true ;
+}
+
+bool crash()
+{
+  abort() ;
+}
+
+ATHENA_TEST( arithmetic )
+{
+  return 1 + 1 == 2 ;
+}
+
 int main()
 {
   athena::Manager manager ;
@@ -73,8 +150,333 @@ int main()
   manager.add( "object_test3", &object, &Object::method3 ) ;
   manager.add( "success"     , &success                  ) ;
   manager.add( "failure"     , &failure                  ) ;
+  manager.benchmark( "sum"   , &sum                      ) ;
+  
+  assert( manager.test( athena::Output::Verbose ) == 2 ) ;
   
+  Counter counter ;
+  
+  manager.addReporter( &counter ) ;
+  manager.setSerial( "object_test3" ) ;
+  assert( manager.test( athena::Output::Normal, 4 ) == 2 ) ;
+  assert( counter.begun == 1 && counter.started == 7 && counter.finished == 7 && counter.failed == 2 ) ;
+  
+  assert( manager.save       ( "athena_baseline.txt" ) ) ;
+  assert( manager.setBaseline( "athena_baseline.txt" ) ) ;
   assert( manager.test( athena::Output::Verbose ) == 2 ) ;
+  remove( "athena_baseline.txt" ) ;
+  
+  athena::Manager merged ;
+  
+  for( unsigned shard = 0; shard < 3; shard++ )
+  {
+    manager.setShard( shard, 3 ) ;
+    manager.test( athena::Output::Quiet, 2 ) ;
+    assert( manager.save( "athena_shard.txt" ) ) ;
+    assert( merged .load( "athena_shard.txt" ) ) ;
+  }
+  
+  merged.initialize( "Athena Merged Shards" ) ;
+  assert( merged.report( athena::Output::Normal ) == 2 ) ;
+  remove( "athena_shard.txt" ) ;
+  manager.setShard( 0, 1 ) ;
+  
+  manager.setTag( "success", "quick" ) ;
+  assert(  manager.include( "object_*"     ) ) ;
+  assert(  manager.include( "tag:quick"    ) ) ;
+  assert(  manager.exclude( "object_test3" ) ) ;
+  assert( !manager.include( "re:(" )         ) ;
+  assert( manager.test( athena::Output::Normal ) == 0 && counter.finished == 24 ) ;
+  
+  manager.clearFilters() ;
+  assert( manager.include( "re:(object_test3|fail.*)" ) ) ;
+  assert( manager.test( athena::Output::Normal ) == 2 && counter.finished == 26 ) ;
+  manager.clearFilters() ;
+  
+#ifdef __unix__
+  athena::Manager isolated ;
+  
+  isolated.initialize  ( "Athena Process Isolation" ) ;
+  isolated.setIsolation( athena::Isolation::Process ) ;
+  isolated.add( "crash"  , &crash   ) ;
+  isolated.add( "success", &success ) ;
+  isolated.add( "failure", &failure ) ;
+  isolated.add( "hang"   , &hang    ) ;
+  isolated.setTimeout( "hang", 20.0 ) ;
+  
+  assert( isolated.test( athena::Output::Verbose, 2 ) == 3 ) ;
+  
+  // A run that dies part way through still leaves the tests it finished in its journal.
+  athena::Manager journaled ;
+  athena::Manager recovered ;
+  std::string     longest   ;
+  int             status    ;
+  pid_t           child     ;
+  
+  // Names longer than any fixed field, differing only at their end, stay apart in the journal.
+  longest = std::string( 200, 'x' ) ;
+  journaled.initialize( "Athena Journal" ) ;
+  journaled.add( "success", &success ) ;
+  journaled.add( "failure", &failure ) ;
+  journaled.add( "crash"  , &crash   ) ;
+  journaled.add( ( longest + "1" ).c_str(), &success ) ;
+  journaled.add( ( longest + "2" ).c_str(), &success ) ;
+  journaled.setSerial ( "crash" ) ;
+  journaled.setRepeat ( 2       ) ;
+  journaled.setJournal( "athena_journal.bin" ) ;
+  
+  fflush( stdout ) ;
+  child = fork() ;
+  if( child == 0 ) _exit( static_cast<int>( journaled.test( athena::Output::Quiet, 1 ) ) ) ;
+  assert( child > 0 && waitpid( child, &status, 0 ) == child && WIFSIGNALED( status ) ) ;
+  
+  recovered.initialize( "Athena Recovered Journal" ) ;
+  recovered.addReporter( &counter ) ;
+  assert( recovered.load( "athena_journal.bin" ) ) ;
+  counter.finished = 0 ;
+  assert( recovered.report( athena::Output::Normal ) == 1 && counter.finished == 5 && counter.runs == 2 ) ;
+  
+  // A run that finishes journals every test.
+  journaled.include( "success" ) ;
+  assert( journaled.test( athena::Output::Quiet ) == 0 ) ;
+  assert( recovered.load( "athena_journal.bin" ) ) ;
+  assert( remove( "athena_journal.bin" ) == 0 ) ;
+#endif
+  
+  athena::Manager formatted ;
+  
+  formatted.initialize( "Athena Formats" ) ;
+  formatted.add( "success", &success ) ;
+  formatted.add( "failure", &failure ) ;
+  assert( !formatted.setFormat( "console,unknown" ) ) ;
+  assert(  formatted.setFormat( "console,junit=athena_junit.xml,jsonl=athena_results.jsonl" ) ) ;
+  assert( formatted.test( athena::Output::Normal, 2 ) == 1 ) ;
+  assert( formatted.setFormat( "console" ) ) ;
+  assert( remove( "athena_junit.xml" ) == 0 && remove( "athena_results.jsonl" ) == 0 ) ;
+  
+  athena::Manager lambdas ;
+  unsigned        calls   = 0 ;
+  double          large[ 16 ] = { 1.0 } ;
+  
+  lambdas.initialize( "Athena Lambdas" ) ;
+  lambdas.add( "capture"  , [&calls]() { calls++ ; return calls == 1 ; } ) ;
+  lambdas.add( "large"    , [large]() { return large[ 0 ] == 1.0 ; } ) ;
+  lambdas.add( "nothing"  , []() {} ) ;
+  lambdas.add( "capture"  , []() { return false ; } ) ;
+  lambdas.benchmark( "loop", [&calls]() { return calls * 2 ; } ) ;
+  assert( lambdas.size() == 5 ) ;
+  assert( lambdas.test( athena::Output::Normal ) == 0 && calls == 1 ) ;
+  
+  athena::Manager           suites                               ;
+  athena::Fixture<Dataset>  shared                               ;
+  athena::Fixture<Dataset>  pooled( athena::Sharing::Worker )    ;
+  
+  suites.initialize( "Athena Fixtures" ) ;
+  for( const char* name : { "shared_first", "shared_second", "shared_third" } )
+  {
+    suites.add( name, shared, []( const Dataset& data ) { return data.values[ 1 ] == 2 ; } ) ;
+  }
+  for( const char* name : { "pooled_first", "pooled_second", "pooled_third" } )
+  {
+    suites.add( name, pooled, []( Dataset& data ) { data.values[ 0 ]++ ; } ) ;
+  }
+  
+  assert( suites.test( athena::Output::Normal, 2 ) == 0 ) ;
+  assert( Dataset::built >= 2 && Dataset::built <= 3 && Dataset::built == Dataset::destroyed ) ;
+  
+  athena::Manager       parameterized             ;
+  std::vector<unsigned> squares( 1000 )           ;
+  std::atomic<unsigned> generated( 0 )            ;
+  
+  for( unsigned index = 0; index < squares.size(); index++ ) squares[ index ] = index * index ;
+  
+  parameterized.initialize( "Athena Parameterized" ) ;
+  parameterized.addCases( "square", squares, []( unsigned value ) { return value % 4 < 2 ; } ) ;
+  parameterized.addCases( "odd"   , std::vector<int>{ 1, 3, 4 }, []( int value ) { return value % 2 == 1 ; } ) ;
+  parameterized.addCases( "sweep" , 100000, [&generated]( std::size_t ) { generated++ ; } ) ;
+  parameterized.addCases( "empty" , 0, []( std::size_t ) { return false ; } ) ;
+  assert( parameterized.size() == 4 ) ;
+  
+  parameterized.addReporter( &counter ) ;
+  parameterized.exclude( "arithmetic" ) ;
+  counter.finished = 0 ;
+  assert( parameterized.test( athena::Output::Quiet, 4 ) == 1 && counter.finished == 101003 && generated == 100000 ) ;
+  
+  athena::Manager counted ;
+  
+  counted.initialize ( "Athena Counters" ) ;
+  counted.setCounters( true ) ;
+  counted.add      ( "success", &success ) ;
+  counted.benchmark( "sum"    , &sum     ) ;
+  assert( counted.setFormat( "console,jsonl=athena_counters.jsonl" ) ) ;
+  assert( counted.test( athena::Output::Verbose, 2 ) == 0 ) ;
+  assert( remove( "athena_counters.jsonl" ) == 0 ) ;
+  
+  // A variant doing a tenth of the work of the first is measured alongside it, and reported as the faster one.
+  athena::Manager varied ;
+  
+  auto work = []( unsigned count ) { unsigned value = 0 ; for( unsigned index = 0; index < count; index++ ) athena::doNotOptimize( value += index * index ) ; return value ; } ;
+  
+  varied.initialize( "Athena Variants" ) ;
+  varied.variant( "square", "slow", [work]() { return work( 1000 ) ; } ) ;
+  varied.variant( "square", "fast", [work]() { return work( 100  ) ; } ) ;
+  varied.addReporter( &counter ) ;
+  assert( varied.setFormat( "console,jsonl=athena_variants.jsonl" ) ) ;
+  assert( varied.test( athena::Output::Verbose ) == 0 ) ;
+  assert( remove( "athena_variants.jsonl" ) == 0 ) ;
+  
+  // Once the timer, the call and the loop are taken out, a benchmark doing nothing measures far less than what was taken out.
+  athena::Manager timed ;
+  
+  timed.benchmark( "empty", []() {} ) ;
+  timed.addReporter( &counter ) ;
+  assert( timed.test( athena::Output::Quiet ) == 0 && counter.statistics.samples != 0 && counter.statistics.median < counter.statistics.overhead / 2.0 ) ;
+  
+  // A linear sweep passes as linear, while a quadratic one expected to be linear fails.
+  athena::Manager swept ;
+  
+  swept.initialize( "Athena Complexity" ) ;
+  swept.complexity( "linear"   , 64 , 65536, [work]( std::uint64_t size ) { return work( static_cast<unsigned>( size ) ) ; } ) ;
+  swept.complexity( "quadratic", 64 , 1024 , [work]( std::uint64_t size ) { unsigned value = 0 ; for( std::uint64_t index = 0; index < size; index++ ) value += work( static_cast<unsigned>( size ) ) ; return value ; } ) ;
+  swept.setComplexity( "linear"   , athena::Complexity::Linear ) ;
+  swept.setComplexity( "quadratic", athena::Complexity::Linear ) ;
+  swept.setThroughput( "linear", 1, sizeof( unsigned ) ) ;
+  assert( swept.setFormat( "console,jsonl=athena_complexity.jsonl" ) ) ;
+  assert( swept.test( athena::Output::Verbose ) == 1 ) ;
+  assert( remove( "athena_complexity.jsonl" ) == 0 ) ;
+  
+  // A counter shared by every thread is measured on one thread, then on two at once.
+  athena::Manager       contended ;
+  std::atomic<unsigned> hits      ;
+  
+  hits = 0 ;
+  contended.initialize( "Athena Contention" ) ;
+  contended.contention( "increment", 2, [&hits]( unsigned thread ) { return hits.fetch_add( thread + 1 ) ; } ) ;
+  contended.addReporter( &counter ) ;
+  assert( contended.setFormat( "console,jsonl=athena_contention.jsonl" ) ) ;
+  assert( contended.test( athena::Output::Verbose ) == 0 && counter.contention.size() == 2 && counter.contention.back().threads == 2 && counter.contention.back().rates.size() == 2 && hits != 0 ) ;
+  assert( remove( "athena_contention.jsonl" ) == 0 ) ;
+  
+  athena::Manager budgeted ;
+  
+  budgeted.initialize( "Athena Budgets" ) ;
+  budgeted.add( "allocating", []() { std::vector<unsigned> values( 64 ) ; return values.size() == 64 ; } ) ;
+  budgeted.add( "frugal"    , []() { return 1 + 1 == 2 ; } ) ;
+  budgeted.setDefaultBudget( 0 ) ;
+  budgeted.setBudget( "allocating", 1, 1024 ) ;
+  assert( budgeted.test( athena::Output::Verbose, 2 ) == 0 ) ;
+  
+  budgeted.setBudget( "allocating", 1, 64 ) ;
+  assert( budgeted.test( athena::Output::Verbose, 2 ) == ( athena::allocationsTracked() ? 1 : 0 ) ) ;
+  
+  athena::Manager       remembered            ;
+  std::atomic<unsigned> attempts( 0 )         ;
+  const char*           arguments[] = { "athena_test", "--history", "athena_history.txt", "--rerun=only-failed" } ;
+  
+  remove( "athena_history.txt" ) ;
+  remembered.add( "flaky"  , [&attempts]() { return ++attempts > 1 ; } ) ;
+  remembered.add( "success", &success ) ;
+  remembered.add( "failure", &failure ) ;
+  assert( remembered.initialize( "Athena History", 4, const_cast<char**>( arguments ) ) ) ;
+  assert( remembered.test( athena::Output::Normal, 2 ) == 2 ) ;
+  
+  // Only the tests that failed last time run again, until the last of them is fixed.
+  remembered.addReporter( &counter ) ;
+  counter.finished = 0 ;
+  assert( remembered.test( athena::Output::Normal, 2 ) == 1 && counter.finished == 2 ) ;
+  
+  remembered.setRerun( athena::Rerun::SkipPassed ) ;
+  remembered.setFailFast( true ) ;
+  counter.finished = 0 ;
+  assert( remembered.test( athena::Output::Normal ) == 1 && counter.finished == 1 ) ;
+  assert( remove( "athena_history.txt" ) == 0 ) ;
+  
+  // A test failing only some of its runs is flaky, whether it's repeated or retried, while one failing every run still fails.
+  athena::Manager       repeated       ;
+  std::atomic<unsigned> runs( 0 )      ;
+  std::atomic<unsigned> retried( 0 )   ;
+  
+  repeated.initialize( "Athena Repeat" ) ;
+  repeated.add( "intermittent", [&runs]() { return ++runs % 3 != 0 ; } ) ;
+  repeated.add( "retried"     , [&retried]() { return ++retried > 1 ; } ) ;
+  repeated.add( "failure"     , &failure ) ;
+  repeated.setRepeat( 5 ) ;
+  repeated.addReporter( &counter ) ;
+  assert( repeated.test( athena::Output::Verbose, 2 ) == 1 && counter.flaky == 2 && runs == 5 ) ;
+  
+  retried = 0 ;
+  repeated.setRepeat ( 1 ) ;
+  repeated.setRetries( 2 ) ;
+  assert( repeated.include( "retried" ) && repeated.include( "failure" ) ) ;
+  assert( repeated.test( athena::Output::Verbose, 2 ) == 1 && counter.flaky == 1 && retried == 2 ) ;
+  
+  // Once the history knows how long each test takes, the slowest one starts first, yet is still reported in name order.
+  athena::Manager scheduled ;
+  
+  remove( "athena_schedule.txt" ) ;
+  scheduled.add( "a_quick", &success ) ;
+  scheduled.add( "b_quick", &success ) ;
+  scheduled.add( "z_slow" , []() { std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) ) ; return true ; } ) ;
+  scheduled.setHistory( "athena_schedule.txt" ) ;
+  scheduled.addReporter( &counter ) ;
+  assert( scheduled.test( athena::Output::Normal, 1 ) == 0 && counter.first == "a_quick" ) ;
+  assert( scheduled.test( athena::Output::Normal, 1 ) == 0 && counter.first == "z_slow" && counter.last == "z_slow" && counter.makespan > 0.0 ) ;
+  assert( remove( "athena_schedule.txt" ) == 0 ) ;
+  
+  // After two failures nothing new starts, and a test stopped by its timeout sees it through athena::cancelled().
+  athena::Manager   stopped         ;
+  std::atomic<bool> exited( false ) ;
+  
+  stopped.add( "failure1", &failure ) ;
+  stopped.add( "failure2", &failure ) ;
+  stopped.add( "failure3", &failure ) ;
+  stopped.add( "success" , &success ) ;
+  stopped.setMaxFailures( 2 ) ;
+  stopped.addReporter( &counter ) ;
+  assert( stopped.test( athena::Output::Normal, 1 ) == 2 && counter.notrun == 2 ) ;
+  
+  stopped.setMaxFailures( 0 ) ;
+  stopped.add( "spin", [&exited]() { while( !athena::cancelled() ) std::this_thread::yield() ; exited = true ; return true ; } ) ;
+  stopped.setTimeout( "spin", 20.0 ) ;
+  assert( stopped.test( athena::Output::Normal, 1 ) == 4 && counter.notrun == 0 ) ;
+  for( unsigned wait = 0; wait < 100 && !exited; wait++ ) std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) ) ;
+  assert( exited ) ;
+  
+#if defined( ATHENA_COROUTINES ) && defined( __linux__ )
+  // A thousand coroutine tests waiting 20ms each take about 20ms on two threads, and wake up on descriptors and timers alike.
+  athena::Manager awaited    ;
+  int             pipes[ 2 ] ;
+  
+  assert( pipe( pipes ) == 0 ) ;
+  awaited.addCases( "delay", 1000, []( std::size_t ) -> athena::Task { co_await athena::delay( 20.0 ) ; co_return true ; } ) ;
+  awaited.add( "read" , [&pipes]() -> athena::Task { char value = 0 ; co_await athena::readable( pipes[ 0 ] ) ; co_return read( pipes[ 0 ], &value, 1 ) == 1 && value == 'a' ; } ) ;
+  awaited.add( "write", [&pipes]() -> athena::Task { co_await athena::delay( 5.0 ) ; co_await athena::writable( pipes[ 1 ] ) ; co_return write( pipes[ 1 ], "a", 1 ) == 1 ; } ) ;
+  awaited.add( "hang" , []() -> athena::Task { co_await athena::delay( 60000.0 ) ; co_return true ; } ) ;
+  awaited.setTimeout( "hang", 20.0 ) ;
+  awaited.addReporter( &counter ) ;
+  counter.finished = 0 ;
+  
+  const auto began = std::chrono::steady_clock::now() ;
+  assert( awaited.test( athena::Output::Normal, 2 ) == 1 && counter.finished == 1004 ) ;
+  assert( std::chrono::steady_clock::now() - began < std::chrono::seconds( 5 ) ) ;
+  
+  close( pipes[ 0 ] ) ;
+  close( pipes[ 1 ] ) ;
+#endif
+  
+  athena::Manager watched ;
+  
+  watched.initialize( "Athena Watchdog" ) ;
+  watched.add( "hang"   , &hang    ) ;
+  watched.add( "success", &success ) ;
+  watched.setTimeout( 50.0 ) ;
+  
+  assert( watched.test( athena::Output::Verbose, 2 ) == 1 ) ;
+  
+  watched.setTimeout  ( 0.0 ) ;
+  watched.setDeadline ( 5.0 ) ;
+  watched.setSerial   ( "success" ) ;
+  assert( watched.test( athena::Output::Verbose ) == 2 ) ;
   
   return 0 ;
 }
\ No newline at end of file
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2020 Jordan Hendl
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* The allocation tracker of the athena_allocations library. Linking it into a program replaces the global operator new and
+ * delete, and interposes malloc, calloc, realloc and free, so every heap allocation of the thread running a test is counted.
+ * Only glibc exposes the allocator underneath malloc, so elsewhere the library tracks nothing.
+ */
+
+#include "Allocations.h"
+
+#if defined( __GLIBC__ )
+#include <cstddef>
+#include <errno.h>
+#include <malloc.h>
+#include <new>
+
+extern "C"
+{
+  void* __libc_malloc  ( std::size_t size                      ) ;
+  void* __libc_calloc  ( std::size_t count, std::size_t size   ) ;
+  void* __libc_realloc ( void* pointer, std::size_t size       ) ;
+  void* __libc_memalign( std::size_t alignment, std::size_t size ) ;
+  void  __libc_free    ( void* pointer                         ) ;
+}
+
+namespace athena
+{
+  /** Structure to contain the allocations counted on a thread.
+   * Kept trivial, so reaching it never runs code or allocates, even from the first malloc of a new thread.
+   */
+  struct Tally
+  {
+    std::uint64_t count  ;
+    std::uint64_t bytes  ;
+    std::int64_t  live   ;
+    std::int64_t  peak   ;
+    bool          active ;
+  };
+
+  /** The allocations counted on the calling thread.
+   */
+  static thread_local Tally tally __attribute__( ( tls_model( "initial-exec" ) ) ) ;
+
+  /** Function to count an allocation.
+   * @param pointer The allocated memory, null if the allocation failed.
+   * @param size The amount of bytes requested.
+   * @return The allocated memory.
+   */
+  static inline void* allocated( void* pointer, std::size_t size )
+  {
+    if( pointer == nullptr || !tally.active ) return pointer ;
+    
+    tally.count++ ;
+    tally.bytes += size ;
+    tally.live  += static_cast<std::int64_t>( malloc_usable_size( pointer ) ) ;
+    if( tally.live > tally.peak ) tally.peak = tally.live ;
+    
+    return pointer ;
+  }
+
+  /** Function to count memory about to be freed.
+   * @param pointer The memory.
+   */
+  static inline void released( void* pointer )
+  {
+    if( pointer == nullptr || !tally.active ) return ;
+    
+    tally.live -= static_cast<std::int64_t>( malloc_usable_size( pointer ) ) ;
+  }
+
+  /** Function to allocate memory for operator new.
+   * @param size The amount of bytes to allocate.
+   * @param alignment The alignment of the memory.
+   * @return The allocated memory, or null if none is left.
+   */
+  static inline void* allocate( std::size_t size, std::size_t alignment )
+  {
+    if( size == 0 ) size = 1 ;
+    
+    return allocated( alignment > alignof( std::max_align_t ) ? __libc_memalign( alignment, size ) : __libc_malloc( size ), size ) ;
+  }
+
+  /** Function to allocate memory for a throwing operator new, retrying with the new handler until it succeeds.
+   * @param size The amount of bytes to allocate.
+   * @param alignment The alignment of the memory.
+   * @return The allocated memory.
+   */
+  static void* allocateOrThrow( std::size_t size, std::size_t alignment )
+  {
+    void*             pointer ;
+    std::new_handler handler ;
+    
+    while( ( pointer = allocate( size, alignment ) ) == nullptr )
+    {
+      handler = std::get_new_handler() ;
+      if( handler == nullptr ) throw std::bad_alloc() ;
+      handler() ;
+    }
+    
+    return pointer ;
+  }
+
+  /** Function to free memory from operator delete.
+   * @param pointer The memory to free.
+   */
+  static inline void deallocate( void* pointer )
+  {
+    released( pointer ) ;
+    __libc_free( pointer ) ;
+  }
+
+  static void startTally()
+  {
+    tally        = Tally() ;
+    tally.active = true    ;
+  }
+
+  static void stopTally( Allocations& allocations )
+  {
+    tally.active = false ;
+    
+    allocations.count = tally.count ;
+    allocations.bytes = tally.bytes ;
+    allocations.peak  = static_cast<std::uint64_t>( tally.peak ) ;
+  }
+
+  /** The tracker of this library.
+   */
+  static const Tracker tracker = { &startTally, &stopTally } ;
+
+  /** Structure to install the tracker before main.
+   */
+  static struct Installer
+  {
+    Installer()
+    {
+      setTracker( &tracker ) ;
+    }
+  } installer ;
+}
+
+extern "C"
+{
+  void* malloc( std::size_t size )
+  {
+    return athena::allocated( __libc_malloc( size ), size ) ;
+  }
+
+  void* calloc( std::size_t count, std::size_t size )
+  {
+    return athena::allocated( __libc_calloc( count, size ), count * size ) ;
+  }
+
+  void* realloc( void* pointer, std::size_t size )
+  {
+    // The old block may be freed by the call, so it is counted as released first.
+    athena::released( pointer ) ;
+    return athena::allocated( __libc_realloc( pointer, size ), size ) ;
+  }
+
+  void free( void* pointer )
+  {
+    athena::deallocate( pointer ) ;
+  }
+
+  void* memalign( std::size_t alignment, std::size_t size )
+  {
+    return athena::allocated( __libc_memalign( alignment, size ), size ) ;
+  }
+
+  void* aligned_alloc( std::size_t alignment, std::size_t size )
+  {
+    return athena::allocated( __libc_memalign( alignment, size ), size ) ;
+  }
+
+  int posix_memalign( void** pointer, std::size_t alignment, std::size_t size )
+  {
+    void* memory ;
+    
+    if( alignment % sizeof( void* ) != 0 || ( alignment & ( alignment - 1 ) ) != 0 ) return EINVAL ;
+    
+    memory = athena::allocated( __libc_memalign( alignment, size ), size ) ;
+    if( memory == nullptr ) return ENOMEM ;
+    
+    *pointer = memory ;
+    return 0 ;
+  }
+}
+
+void* operator new  ( std::size_t size                                               ) { return athena::allocateOrThrow( size, alignof( std::max_align_t ) ) ; }
+void* operator new[]( std::size_t size                                               ) { return athena::allocateOrThrow( size, alignof( std::max_align_t ) ) ; }
+void* operator new  ( std::size_t size, const std::nothrow_t&                        ) noexcept { return athena::allocate( size, alignof( std::max_align_t ) ) ; }
+void* operator new[]( std::size_t size, const std::nothrow_t&                        ) noexcept { return athena::allocate( size, alignof( std::max_align_t ) ) ; }
+void* operator new  ( std::size_t size, std::align_val_t alignment                   ) { return athena::allocateOrThrow( size, static_cast<std::size_t>( alignment ) ) ; }
+void* operator new[]( std::size_t size, std::align_val_t alignment                   ) { return athena::allocateOrThrow( size, static_cast<std::size_t>( alignment ) ) ; }
+void* operator new  ( std::size_t size, std::align_val_t alignment, const std::nothrow_t& ) noexcept { return athena::allocate( size, static_cast<std::size_t>( alignment ) ) ; }
+void* operator new[]( std::size_t size, std::align_val_t alignment, const std::nothrow_t& ) noexcept { return athena::allocate( size, static_cast<std::size_t>( alignment ) ) ; }
+
+void operator delete  ( void* pointer                                                    ) noexcept { athena::deallocate( pointer ) ; }
+void operator delete[]( void* pointer                                                    ) noexcept { athena::deallocate( pointer ) ; }
+void operator delete  ( void* pointer, std::size_t                                       ) noexcept { athena::deallocate( pointer ) ; }
+void operator delete[]( void* pointer, std::size_t                                       ) noexcept { athena::deallocate( pointer ) ; }
+void operator delete  ( void* pointer, const std::nothrow_t&                             ) noexcept { athena::deallocate( pointer ) ; }
+void operator delete[]( void* pointer, const std::nothrow_t&                             ) noexcept { athena::deallocate( pointer ) ; }
+void operator delete  ( void* pointer, std::align_val_t                                  ) noexcept { athena::deallocate( pointer ) ; }
+void operator delete[]( void* pointer, std::align_val_t                                  ) noexcept { athena::deallocate( pointer ) ; }
+void operator delete  ( void* pointer, std::size_t, std::align_val_t                     ) noexcept { athena::deallocate( pointer ) ; }
+void operator delete[]( void* pointer, std::size_t, std::align_val_t                     ) noexcept { athena::deallocate( pointer ) ; }
+void operator delete  ( void* pointer, std::align_val_t, const std::nothrow_t&           ) noexcept { athena::deallocate( pointer ) ; }
+void operator delete[]( void* pointer, std::align_val_t, const std::nothrow_t&           ) noexcept { athena::deallocate( pointer ) ; }
+#endif